@@ -37,6 +37,9 @@ from .api import (
     refresh_sessions,
 )
 
+# Include/exclude capture planning
+from .capture_sets import open_capture, CaptureSet
+
 # Import utils module
 from . import utils
 
@@ -85,6 +88,10 @@ __all__ = [
     'mute_app',
     'unmute_app',
 
+    # Include/exclude capture planning
+    'open_capture',
+    'CaptureSet',
+
     # Utilities
     'convert_float32_to_int16',
     'utils',
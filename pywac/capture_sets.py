@@ -0,0 +1,182 @@
+"""
+Minimal-stream capture planning for include/exclude PID sets.
+
+The OS can express two things in a single process-loopback stream:
+one process tree ("include"), or everything except one process tree
+("exclude"). `open_capture` maps an arbitrary include/exclude request
+onto the fewest native streams that cover it:
+
+- ``exclude={pid}``            -> ONE exclude-tree stream
+- ``include={pid}``            -> one include-tree stream
+- ``include={pid, pid, ...}``  -> one stream per PID, mixed natively
+  into a single output via :class:`pywac.capture.StreamMixer`
+- ``exclude={pid, pid, ...}``  -> the OS takes a single excluded tree
+  per stream, so this falls back to including every other current
+  audio process (mixed)
+
+Example - "everything except Discord", one capture stack::
+
+    import pywac
+    cset = pywac.open_capture(exclude={discord_pid})
+    cset.start()
+    chunks = cset.pop_chunks(timeout_ms=50)
+    cset.stop()
+"""
+
+from typing import Dict, Iterable, List, Optional
+
+
+def _import_capture():
+    """Helper function to import pywac.capture module."""
+    try:
+        from pywac import capture
+        return capture
+    except ImportError:
+        return None
+
+
+class CaptureSet:
+    """A group of native capture streams behind one pop interface.
+
+    Created by :func:`open_capture`; not usually constructed directly.
+    With a single stream, ``pop_chunks`` returns that stream's chunks;
+    with several, they are mixed natively and ``pop_chunks`` returns the
+    mixed output (see ``StreamMixer.pop_chunks`` for the dict shape).
+    """
+
+    def __init__(self, captures, pids, mixer=None, exclude_tree=False):
+        self._captures = captures
+        self._pids = list(pids)
+        self._mixer = mixer
+        self._exclude_tree = exclude_tree
+        self._running = False
+        self._streams_added = False
+
+    @property
+    def stream_count(self) -> int:
+        """Number of native capture streams backing this set."""
+        return len(self._captures)
+
+    @property
+    def pids(self) -> List[int]:
+        """Target PIDs, one per stream (the excluded PID in exclude mode)."""
+        return list(self._pids)
+
+    def start(self, timeout_ms: int = 10000) -> bool:
+        """Start every stream (and the mixer, if any).
+
+        Returns True only if all streams started; on partial failure the
+        already-started streams are stopped again.
+        """
+        if self._running:
+            return True
+
+        started = []
+        for cap, pid in zip(self._captures, self._pids):
+            if cap.start(pid, timeout_ms=timeout_ms):
+                started.append(cap)
+            else:
+                for other in started:
+                    other.stop()
+                return False
+
+        if self._mixer is not None:
+            # StreamMixer has no remove API, so register each capture
+            # exactly once - re-adding on a stop()/start() cycle (or a
+            # retry after a failed mixer start) would give the mixer two
+            # inputs draining the same queue
+            if not self._streams_added:
+                for cap in self._captures:
+                    self._mixer.add_stream(cap)
+                self._streams_added = True
+            if not self._mixer.start():
+                for cap in self._captures:
+                    cap.stop()
+                return False
+
+        self._running = True
+        return True
+
+    def stop(self) -> None:
+        """Stop the mixer (if any) and every stream."""
+        if self._mixer is not None:
+            self._mixer.stop()
+        for cap in self._captures:
+            cap.stop()
+        self._running = False
+
+    def pop_chunks(self, max_chunks: int = 10, timeout_ms: int = 10) -> list:
+        """Pop chunks from the (single or mixed) output stream."""
+        if self._mixer is not None:
+            return self._mixer.pop_chunks(max_chunks=max_chunks,
+                                          timeout_ms=timeout_ms)
+        return self._captures[0].pop_chunks(max_chunks=max_chunks,
+                                            timeout_ms=timeout_ms)
+
+    def get_metrics(self) -> Dict:
+        """Per-stream metrics plus the mixer's, when one is in use."""
+        metrics = {
+            'stream_count': self.stream_count,
+            'exclude_tree': self._exclude_tree,
+            'pids': self.pids,
+            'streams': [cap.get_metrics() for cap in self._captures],
+        }
+        if self._mixer is not None:
+            metrics['mixer'] = self._mixer.get_metrics()
+        return metrics
+
+
+def open_capture(include: Optional[Iterable[int]] = None,
+                 exclude: Optional[Iterable[int]] = None,
+                 queue_size: int = 1000,
+                 chunk_frames: int = 480) -> CaptureSet:
+    """Build the minimal set of native streams for the given PID sets.
+
+    Args:
+        include: PIDs whose audio should be captured
+        exclude: PIDs whose audio must NOT be captured
+        queue_size: per-stream chunk queue size
+        chunk_frames: mixer output chunk size (multi-stream sets only)
+
+    Returns:
+        An un-started :class:`CaptureSet`; call ``start()`` on it.
+
+    Raises:
+        RuntimeError: native extensions are not built
+        ValueError: the request resolves to nothing to capture
+    """
+    capture = _import_capture()
+    if capture is None:
+        raise RuntimeError(
+            "pywac.capture is not built. Run: python setup.py build_ext --inplace")
+
+    include = set(include or ())
+    exclude = set(exclude or ())
+    include -= exclude
+
+    if not include and len(exclude) == 1:
+        # The common case: "everything except this app" is exactly what
+        # EXCLUDE_TARGET_PROCESS_TREE does in one stream
+        cap = capture.QueueBasedProcessCapture(queue_size=queue_size)
+        cap.set_exclude_process_tree(True)
+        return CaptureSet([cap], [exclude.pop()], exclude_tree=True)
+
+    if not include and exclude:
+        # Multiple excluded trees cannot share one stream, so include
+        # every other process currently able to produce audio instead
+        audio_pids = {proc.pid for proc in capture.list_audio_processes()}
+        include = audio_pids - exclude
+
+    if not include:
+        raise ValueError("Nothing to capture: give include PIDs, or exclude "
+                         "PIDs that leave at least one audio process")
+
+    pids = sorted(include)
+    captures = [capture.QueueBasedProcessCapture(queue_size=queue_size)
+                for _ in pids]
+    if len(pids) == 1:
+        return CaptureSet(captures, pids)
+
+    mixer = capture.StreamMixer(chunk_frames=chunk_frames,
+                                queue_size=queue_size)
+    return CaptureSet(captures, pids, mixer=mixer)
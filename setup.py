@@ -27,7 +27,7 @@ ext_modules = [
         "pywac.core",  # Core module: session enumeration and system loopback
         ["src/audio_session_capture.cpp"],
         include_dirs=[],
-        libraries=["ole32", "uuid", "mmdevapi", "psapi"],
+        libraries=["ole32", "uuid", "mmdevapi", "avrt", "psapi"],
         language="c++",
         cxx_std=17,
     ),
@@ -35,7 +35,16 @@ ext_modules = [
         "pywac.capture",  # Capture module: process-specific audio capture
         ["src/process_loopback_queue.cpp"],
         include_dirs=[],
-        libraries=["ole32", "uuid", "mmdevapi", "avrt", "runtimeobject", "psapi"],
+        libraries=["ole32", "uuid", "mmdevapi", "avrt", "runtimeobject", "psapi",
+                   "mfplat", "mfreadwrite", "mfuuid"],
+        language="c++",
+        cxx_std=17,
+    ),
+    Pybind11Extension(
+        "pywac.bench",  # Micro-benchmarks for the capture internals (no WASAPI dependency)
+        ["src/capture_bench.cpp"],
+        include_dirs=[],
+        libraries=[],
         language="c++",
         cxx_std=17,
     ),
@@ -8,11 +8,19 @@
 #include <endpointvolume.h>
 #include <functiondiscoverykeys_devpkey.h>
 #include <wrl/client.h>
+#include <wrl/implements.h>
+#include <avrt.h>
 #include <vector>
 #include <string>
 #include <map>
+#include <deque>
 #include <mutex>
 #include <memory>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
 #include <psapi.h>
 #include <tlhelp32.h>
 
@@ -34,14 +42,163 @@ struct AudioSessionInfo {
     bool muted;
 };
 
+// One session lifecycle event, produced on a COM worker thread and
+// drained from Python with pop_events(). Replaces enumerate_sessions()
+// polling: O(1) per actual change instead of a full COM walk per poll.
+struct SessionEvent {
+    enum Type { kCreated = 0, kStateChanged, kVolumeChanged, kDisconnected };
+    int type = kCreated;
+    DWORD pid = 0;
+    int state = -1;         // AudioSessionState, for kStateChanged
+    float volume = -1.0f;   // for kVolumeChanged
+    bool muted = false;     // for kVolumeChanged
+    int reason = -1;        // AudioSessionDisconnectReason, for kDisconnected
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+// Per-session IAudioSessionEvents listener: forwards state/volume
+// changes into the enumerator's event queue. One instance is registered
+// per cached session while the subscription is active.
+class SessionEventsClient : public RuntimeClass<RuntimeClassFlags<ClassicCom>, FtmBase,
+                                                IAudioSessionEvents> {
+private:
+    DWORD pid = 0;
+    std::function<void(SessionEvent&&)> sink;
+
+    void emit(SessionEvent&& e) {
+        e.pid = pid;
+        e.timestamp = std::chrono::steady_clock::now();
+        if (sink) sink(std::move(e));
+    }
+
+public:
+    void SetSink(DWORD processId, std::function<void(SessionEvent&&)> callback) {
+        pid = processId;
+        sink = std::move(callback);
+    }
+
+    STDMETHOD(OnDisplayNameChanged)(LPCWSTR, LPCGUID) override { return S_OK; }
+    STDMETHOD(OnIconPathChanged)(LPCWSTR, LPCGUID) override { return S_OK; }
+    STDMETHOD(OnChannelVolumeChanged)(DWORD, float*, DWORD, LPCGUID) override { return S_OK; }
+    STDMETHOD(OnGroupingParamChanged)(LPCGUID, LPCGUID) override { return S_OK; }
+
+    STDMETHOD(OnSimpleVolumeChanged)(float newVolume, BOOL newMute, LPCGUID) override {
+        SessionEvent e;
+        e.type = SessionEvent::kVolumeChanged;
+        e.volume = newVolume;
+        e.muted = (newMute == TRUE);
+        emit(std::move(e));
+        return S_OK;
+    }
+
+    STDMETHOD(OnStateChanged)(AudioSessionState newState) override {
+        SessionEvent e;
+        e.type = SessionEvent::kStateChanged;
+        e.state = static_cast<int>(newState);
+        emit(std::move(e));
+        return S_OK;
+    }
+
+    STDMETHOD(OnSessionDisconnected)(AudioSessionDisconnectReason reason) override {
+        SessionEvent e;
+        e.type = SessionEvent::kDisconnected;
+        e.reason = static_cast<int>(reason);
+        emit(std::move(e));
+        return S_OK;
+    }
+};
+
+// Receives new-session callbacks from the session manager so the cache
+// below can be maintained incrementally instead of re-walking COM on
+// every lookup. Callbacks arrive on a COM worker thread.
+class SessionNotificationClient : public RuntimeClass<RuntimeClassFlags<ClassicCom>, FtmBase,
+                                                      IAudioSessionNotification> {
+private:
+    std::function<void(IAudioSessionControl*)> onCreated;
+
+public:
+    void SetCallback(std::function<void(IAudioSessionControl*)> callback) {
+        onCreated = std::move(callback);
+    }
+
+    STDMETHOD(OnSessionCreated)(IAudioSessionControl* newSession) override {
+        if (onCreated && newSession) {
+            onCreated(newSession);
+        }
+        return S_OK;
+    }
+};
+
 class AudioSessionEnumerator {
 private:
+    // One cached entry per live session: the volume interface is kept so
+    // volume/mute changes need no enumeration and no OpenProcess churn
+    struct CachedSession {
+        ComPtr<IAudioSessionControl> control;
+        ComPtr<IAudioSessionControl2> control2;
+        ComPtr<ISimpleAudioVolume> volume;
+        ComPtr<SessionEventsClient> events;   // registered while subscribed
+    };
+
     ComPtr<IMMDeviceEnumerator> deviceEnumerator;
     ComPtr<IMMDevice> defaultDevice;
     ComPtr<IAudioSessionManager2> sessionManager;
-    std::vector<AudioSessionInfo> sessions;
     bool comInitialized = false;
-    
+
+    std::multimap<DWORD, CachedSession> sessionCache;
+    mutable std::mutex cacheMutex;
+    std::atomic<bool> cachePrimed{false};
+    ComPtr<SessionNotificationClient> notificationClient;
+    bool notificationRegistered = false;
+    size_t cacheHits = 0;
+    size_t cacheMisses = 0;
+
+    // Process-name cache. The held handle serves two purposes: liveness
+    // is a free WaitForSingleObject(0) instead of an OpenProcess, and
+    // Windows cannot recycle the PID while the handle is open, so a live
+    // process guarantees the cached name is still the right one.
+    struct CachedProcessName {
+        std::string name;
+        HANDLE handle = nullptr;
+        FILETIME creationTime = {};
+    };
+    std::map<DWORD, CachedProcessName> nameCache;
+    mutable std::mutex nameCacheMutex;
+    size_t nameCacheHits = 0;
+    size_t nameCacheMisses = 0;
+
+    // Push-based session events: a small bounded queue (same pattern as
+    // the capture module's chunk queue - drop-oldest with a counter)
+    // filled by the COM callbacks above and drained with pop_events()
+    std::deque<SessionEvent> eventQueue;
+    mutable std::mutex eventMutex;
+    std::condition_variable eventCv;
+    static constexpr size_t kMaxQueuedEvents = 1000;
+    size_t droppedEvents = 0;
+    std::atomic<bool> eventsEnabled{false};
+
+    void PushEvent(SessionEvent&& e) {
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            if (!eventsEnabled.load()) return;
+            if (eventQueue.size() >= kMaxQueuedEvents) {
+                eventQueue.pop_front();
+                droppedEvents++;
+            }
+            eventQueue.push_back(std::move(e));
+        }
+        eventCv.notify_one();
+    }
+
+    // Unregister a session's events listener. Caller holds cacheMutex
+    // (or is the destructor).
+    void DetachSessionEvents(CachedSession& cached) {
+        if (cached.events && cached.control) {
+            cached.control->UnregisterAudioSessionNotification(cached.events.Get());
+        }
+        cached.events.Reset();
+    }
+
 public:
     AudioSessionEnumerator() {
         HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
@@ -55,115 +212,281 @@ public:
     }
     
     ~AudioSessionEnumerator() {
+        if (notificationRegistered && sessionManager && notificationClient) {
+            sessionManager->UnregisterSessionNotification(notificationClient.Get());
+        }
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            for (auto& pair : sessionCache) {
+                DetachSessionEvents(pair.second);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(nameCacheMutex);
+            for (auto& pair : nameCache) {
+                if (pair.second.handle) CloseHandle(pair.second.handle);
+            }
+            nameCache.clear();
+        }
         if (comInitialized) {
             CoUninitialize();
         }
     }
-    
+
     bool Initialize() {
         HRESULT hr;
-        
+
         // Create device enumerator
         hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr,
             CLSCTX_ALL, __uuidof(IMMDeviceEnumerator),
             reinterpret_cast<void**>(deviceEnumerator.GetAddressOf()));
-        
+
         if (FAILED(hr)) return false;
-        
+
         // Get default audio endpoint
         hr = deviceEnumerator->GetDefaultAudioEndpoint(
             eRender, eConsole, &defaultDevice);
-        
+
         if (FAILED(hr)) return false;
-        
+
         // Get session manager
         hr = defaultDevice->Activate(__uuidof(IAudioSessionManager2),
             CLSCTX_ALL, nullptr,
             reinterpret_cast<void**>(sessionManager.GetAddressOf()));
-        
-        return SUCCEEDED(hr);
+
+        if (FAILED(hr)) return false;
+
+        // Keep the cache current incrementally: new sessions arrive via
+        // callback instead of being discovered by the next full walk
+        notificationClient = Make<SessionNotificationClient>();
+        if (notificationClient) {
+            notificationClient->SetCallback([this](IAudioSessionControl* control) {
+                AddSessionToCache(control, true);
+            });
+            hr = sessionManager->RegisterSessionNotification(notificationClient.Get());
+            notificationRegistered = SUCCEEDED(hr);
+        }
+
+        return true;
     }
-    
-    std::vector<AudioSessionInfo> EnumerateSessions() {
-        sessions.clear();
-        
-        if (!sessionManager) return sessions;
-        
+
+    // Insert one session into the cache. Called from the notification
+    // callback (COM worker thread, fromNotification=true) and from
+    // RefreshCache. While a subscription is active the session also gets
+    // an IAudioSessionEvents listener, and genuinely new sessions emit a
+    // "created" event.
+    void AddSessionToCache(IAudioSessionControl* control, bool fromNotification = false) {
+        if (!control) return;
+
+        CachedSession entry;
+        entry.control = control;
+
+        HRESULT hr = entry.control.As(&entry.control2);
+        if (FAILED(hr)) return;
+
+        DWORD pid = 0;
+        hr = entry.control2->GetProcessId(&pid);
+        if (FAILED(hr) || pid == 0) return;
+
+        hr = entry.control2.As(&entry.volume);
+        if (FAILED(hr)) return;
+
+        if (eventsEnabled.load()) {
+            entry.events = Make<SessionEventsClient>();
+            if (entry.events) {
+                entry.events->SetSink(pid, [this](SessionEvent&& e) {
+                    PushEvent(std::move(e));
+                });
+                if (FAILED(entry.control->RegisterAudioSessionNotification(
+                        entry.events.Get()))) {
+                    entry.events.Reset();
+                }
+            }
+        }
+
+        bool inserted = false;
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            // Avoid duplicates for the same session interface
+            auto range = sessionCache.equal_range(pid);
+            bool duplicate = false;
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second.control.Get() == control) { duplicate = true; break; }
+            }
+            if (!duplicate) {
+                sessionCache.emplace(pid, std::move(entry));
+                inserted = true;
+            }
+        }
+
+        if (!inserted) {
+            DetachSessionEvents(entry);
+            return;
+        }
+
+        if (fromNotification && eventsEnabled.load()) {
+            SessionEvent e;
+            e.type = SessionEvent::kCreated;
+            e.pid = pid;
+            e.timestamp = std::chrono::steady_clock::now();
+            PushEvent(std::move(e));
+        }
+    }
+
+    // Full COM walk. Only needed at first use, on explicit refresh(), or
+    // after a cache entry turns out to be stale.
+    void RefreshCache() {
+        if (!sessionManager) return;
+
         ComPtr<IAudioSessionEnumerator> sessionEnumerator;
         HRESULT hr = sessionManager->GetSessionEnumerator(&sessionEnumerator);
-        
-        if (FAILED(hr)) return sessions;
-        
+        if (FAILED(hr)) return;
+
         int sessionCount = 0;
         hr = sessionEnumerator->GetCount(&sessionCount);
-        
-        if (FAILED(hr)) return sessions;
-        
+        if (FAILED(hr)) return;
+
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            for (auto& pair : sessionCache) {
+                DetachSessionEvents(pair.second);
+            }
+            sessionCache.clear();
+            cachePrimed = true;
+        }
+
         for (int i = 0; i < sessionCount; i++) {
             ComPtr<IAudioSessionControl> sessionControl;
             hr = sessionEnumerator->GetSession(i, &sessionControl);
-            
             if (FAILED(hr)) continue;
-            
-            // Get extended session control
-            ComPtr<IAudioSessionControl2> sessionControl2;
-            hr = sessionControl.As(&sessionControl2);
-            
-            if (FAILED(hr)) continue;
-            
+            AddSessionToCache(sessionControl.Get());
+        }
+    }
+
+    // Drop sessions that have expired so the cache tracks reality
+    // without waiting for an explicit refresh
+    void PruneExpiredSessions() {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        for (auto it = sessionCache.begin(); it != sessionCache.end();) {
+            AudioSessionState state = AudioSessionStateInactive;
+            HRESULT hr = it->second.control->GetState(&state);
+            if (FAILED(hr) || state == AudioSessionStateExpired) {
+                DetachSessionEvents(it->second);
+                it = sessionCache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    std::vector<AudioSessionInfo> EnumerateSessions() {
+        // Results build in a local vector: enumerate_sessions runs with
+        // the GIL released, so a member buffer would race between callers
+        std::vector<AudioSessionInfo> sessions;
+
+        if (!sessionManager) return sessions;
+
+        if (!cachePrimed) {
+            RefreshCache();
+        }
+        PruneExpiredSessions();
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        for (auto& pair : sessionCache) {
+            const CachedSession& cached = pair.second;
             AudioSessionInfo info = {};
-            
-            // Get process ID
-            hr = sessionControl2->GetProcessId(&info.processId);
-            if (FAILED(hr) || info.processId == 0) continue;
-            
+            info.processId = pair.first;
+
             // Get session state
-            hr = sessionControl->GetState(&info.state);
-            
+            HRESULT hr = cached.control->GetState(&info.state);
+            if (FAILED(hr)) continue;
+
             // Get session ID
             LPWSTR sessionId = nullptr;
-            hr = sessionControl2->GetSessionIdentifier(&sessionId);
+            hr = cached.control2->GetSessionIdentifier(&sessionId);
             if (SUCCEEDED(hr) && sessionId) {
                 info.sessionId = sessionId;
                 CoTaskMemFree(sessionId);
             }
-            
+
             // Get display name
             LPWSTR displayName = nullptr;
-            hr = sessionControl->GetDisplayName(&displayName);
+            hr = cached.control->GetDisplayName(&displayName);
             if (SUCCEEDED(hr) && displayName) {
                 std::wstring wname(displayName);
                 info.displayName = std::string(wname.begin(), wname.end());
                 CoTaskMemFree(displayName);
             }
-            
+
             // Get process name
             info.processName = GetProcessName(info.processId);
-            
-            // Get volume control
-            ComPtr<ISimpleAudioVolume> volumeControl;
-            hr = sessionControl2.As(&volumeControl);
-            if (SUCCEEDED(hr)) {
-                volumeControl->GetMasterVolume(&info.volume);
+
+            // Get volume state
+            if (cached.volume) {
+                cached.volume->GetMasterVolume(&info.volume);
                 BOOL muted = FALSE;
-                volumeControl->GetMute(&muted);
+                cached.volume->GetMute(&muted);
                 info.muted = (muted == TRUE);
             }
-            
+
             sessions.push_back(info);
         }
-        
+
         return sessions;
     }
     
     std::string GetProcessName(DWORD processId) {
+        // Cached path: names never change for a living PID, so repeated
+        // enumerations resolve known PIDs with zero OpenProcess calls
+        {
+            std::lock_guard<std::mutex> lock(nameCacheMutex);
+            auto it = nameCache.find(processId);
+            if (it != nameCache.end()) {
+                if (it->second.handle &&
+                    WaitForSingleObject(it->second.handle, 0) == WAIT_TIMEOUT) {
+                    nameCacheHits++;
+                    return it->second.name;
+                }
+                // Process exited - the PID may be recycled from here on
+                if (it->second.handle) CloseHandle(it->second.handle);
+                nameCache.erase(it);
+            }
+            nameCacheMisses++;
+        }
+
+        std::string processName = ResolveProcessName(processId);
+
+        // Cache the result with a limited handle for future validation.
+        // If the open fails (elevated process), the name is simply
+        // re-resolved on each enumeration as before.
+        HANDLE hCache = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+        if (hCache && processName != "Unknown") {
+            CachedProcessName entry;
+            entry.name = processName;
+            entry.handle = hCache;
+
+            FILETIME exitTime, kernelTime, userTime;
+            GetProcessTimes(hCache, &entry.creationTime, &exitTime,
+                            &kernelTime, &userTime);
+
+            std::lock_guard<std::mutex> lock(nameCacheMutex);
+            auto inserted = nameCache.emplace(processId, std::move(entry));
+            if (!inserted.second) CloseHandle(hCache);
+        } else if (hCache) {
+            CloseHandle(hCache);
+        }
+
+        return processName;
+    }
+
+    std::string ResolveProcessName(DWORD processId) {
         std::string processName = "Unknown";
-        
+
         // First try with PROCESS_QUERY_LIMITED_INFORMATION (works for more processes)
         HANDLE hProcess = OpenProcess(
             PROCESS_QUERY_LIMITED_INFORMATION,
             FALSE, processId);
-        
+
         if (hProcess) {
             char buffer[MAX_PATH];
             DWORD bufferSize = MAX_PATH;
@@ -201,56 +524,385 @@ public:
     }
     
     bool SetSessionVolume(DWORD processId, float volume) {
-        auto sessions = EnumerateSessions();
-        
-        for (const auto& session : sessions) {
-            if (session.processId == processId) {
-                // Re-get the session control to modify volume
-                ComPtr<IAudioSessionEnumerator> sessionEnumerator;
-                HRESULT hr = sessionManager->GetSessionEnumerator(&sessionEnumerator);
-                if (FAILED(hr)) return false;
-                
-                int sessionCount = 0;
-                hr = sessionEnumerator->GetCount(&sessionCount);
-                if (FAILED(hr)) return false;
-                
-                for (int i = 0; i < sessionCount; i++) {
-                    ComPtr<IAudioSessionControl> sessionControl;
-                    hr = sessionEnumerator->GetSession(i, &sessionControl);
-                    if (FAILED(hr)) continue;
-                    
-                    ComPtr<IAudioSessionControl2> sessionControl2;
-                    hr = sessionControl.As(&sessionControl2);
-                    if (FAILED(hr)) continue;
-                    
-                    DWORD pid = 0;
-                    hr = sessionControl2->GetProcessId(&pid);
-                    if (FAILED(hr) || pid != processId) continue;
-                    
-                    ComPtr<ISimpleAudioVolume> volumeControl;
-                    hr = sessionControl2.As(&volumeControl);
-                    if (SUCCEEDED(hr)) {
-                        hr = volumeControl->SetMasterVolume(volume, nullptr);
-                        return SUCCEEDED(hr);
+        if (!cachePrimed) {
+            RefreshCache();
+        }
+
+        // Fast path: the cached ISimpleAudioVolume, no enumeration and no
+        // process-handle churn
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            auto range = sessionCache.equal_range(processId);
+            bool applied = false;
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second.volume &&
+                    SUCCEEDED(it->second.volume->SetMasterVolume(volume, nullptr))) {
+                    applied = true;
+                }
+            }
+            if (applied) {
+                cacheHits++;
+                return true;
+            }
+            cacheMisses++;
+        }
+
+        // Miss or stale entry: rebuild the cache once and retry
+        RefreshCache();
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto range = sessionCache.equal_range(processId);
+        bool applied = false;
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.volume &&
+                SUCCEEDED(it->second.volume->SetMasterVolume(volume, nullptr))) {
+                applied = true;
+            }
+        }
+        return applied;
+    }
+
+    // Apply a whole scene of volume/mute changes in one pass over the
+    // session cache. Each entry is a dict with "pid" plus an optional
+    // "volume" and/or "mute". All entries are applied under a single
+    // cache-lock acquisition; only if some PID is missing is the cache
+    // rebuilt - once - and the misses retried. Ten SetSessionVolume
+    // calls collapse into at most two cache passes.
+    py::list ApplySessionSettings(py::list settings) {
+        struct Entry {
+            DWORD pid = 0;
+            bool hasVolume = false;
+            float volume = 1.0f;
+            bool hasMute = false;
+            bool mute = false;
+            bool success = false;
+        };
+
+        std::vector<Entry> entries;
+        entries.reserve(py::len(settings));
+        for (auto item : settings) {
+            py::dict d = item.cast<py::dict>();
+            Entry e;
+            e.pid = d["pid"].cast<DWORD>();
+            if (d.contains("volume")) {
+                e.hasVolume = true;
+                e.volume = d["volume"].cast<float>();
+            }
+            if (d.contains("mute")) {
+                e.hasMute = true;
+                e.mute = d["mute"].cast<bool>();
+            }
+            entries.push_back(e);
+        }
+
+        // The apply passes are pure COM and cache work (and RefreshCache
+        // can walk every session on the system), so they run without the
+        // GIL; it is reacquired below to build the results list
+        py::gil_scoped_release release;
+
+        if (!cachePrimed) {
+            RefreshCache();
+        }
+
+        auto applyPass = [&](bool countStats) {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            for (auto& e : entries) {
+                if (e.success) continue;
+
+                auto range = sessionCache.equal_range(e.pid);
+                bool applied = false;
+                for (auto it = range.first; it != range.second; ++it) {
+                    if (!it->second.volume) continue;
+
+                    bool ok = true;
+                    if (e.hasVolume &&
+                        FAILED(it->second.volume->SetMasterVolume(e.volume, nullptr))) {
+                        ok = false;
+                    }
+                    if (e.hasMute &&
+                        FAILED(it->second.volume->SetMute(e.mute ? TRUE : FALSE, nullptr))) {
+                        ok = false;
                     }
+                    if (ok) applied = true;
+                }
+
+                e.success = applied;
+                if (countStats) {
+                    if (applied) cacheHits++; else cacheMisses++;
                 }
             }
+        };
+
+        applyPass(true);
+
+        bool anyMissed = false;
+        for (const auto& e : entries) {
+            if (!e.success) { anyMissed = true; break; }
         }
-        
-        return false;
+
+        // Misses or stale entries: rebuild the cache once and retry only
+        // the entries that failed
+        if (anyMissed) {
+            RefreshCache();
+            applyPass(false);
+        }
+
+        py::gil_scoped_acquire acquire;
+        py::list results;
+        for (const auto& e : entries) {
+            py::dict r;
+            r["pid"] = e.pid;
+            r["success"] = e.success;
+            results.append(r);
+        }
+        return results;
+    }
+
+    // Force a full re-walk of the session list into the cache
+    void Refresh() {
+        RefreshCache();
+    }
+
+    // Turn the push-based event stream on or off. Enabling attaches an
+    // IAudioSessionEvents listener to every current session (via a cache
+    // refresh) and to every future one (via the session-created
+    // notification); disabling detaches them all and drops queued events.
+    void SubscribeEvents(bool enabled = true) {
+        if (enabled == eventsEnabled.load()) return;
+
+        if (enabled) {
+            eventsEnabled = true;
+            RefreshCache();
+            return;
+        }
+
+        eventsEnabled = false;
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            for (auto& pair : sessionCache) {
+                DetachSessionEvents(pair.second);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            eventQueue.clear();
+            droppedEvents = 0;
+        }
+    }
+
+    // Drain queued session events, waiting up to timeout_ms for the
+    // first one. Each event is a dict: type ('created' / 'state_changed'
+    // / 'volume_changed' / 'disconnected'), pid, timestamp (us), plus
+    // state (SessionState value), or volume/muted, or reason.
+    py::list PopEvents(size_t maxEvents = 64, int timeoutMs = 100) {
+        std::vector<SessionEvent> events;
+        {
+            py::gil_scoped_release release;
+            std::unique_lock<std::mutex> lock(eventMutex);
+            eventCv.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                             [this] { return !eventQueue.empty(); });
+            while (!eventQueue.empty() && events.size() < maxEvents) {
+                events.push_back(std::move(eventQueue.front()));
+                eventQueue.pop_front();
+            }
+        }
+
+        static const char* typeNames[] = {
+            "created", "state_changed", "volume_changed", "disconnected"
+        };
+
+        py::list result;
+        for (const auto& e : events) {
+            py::dict d;
+            d["type"] = typeNames[e.type];
+            d["pid"] = e.pid;
+            d["timestamp"] = std::chrono::duration_cast<std::chrono::microseconds>(
+                e.timestamp.time_since_epoch()).count();
+            if (e.type == SessionEvent::kStateChanged) {
+                d["state"] = e.state;
+            } else if (e.type == SessionEvent::kVolumeChanged) {
+                d["volume"] = e.volume;
+                d["muted"] = e.muted;
+            } else if (e.type == SessionEvent::kDisconnected) {
+                d["reason"] = e.reason;
+            }
+            result.append(d);
+        }
+        return result;
+    }
+
+    py::dict GetCacheStats() const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        py::dict stats;
+        stats["cached_sessions"] = sessionCache.size();
+        stats["cache_hits"] = cacheHits;
+        stats["cache_misses"] = cacheMisses;
+        stats["notifications_registered"] = notificationRegistered;
+        stats["events_enabled"] = eventsEnabled.load();
+        {
+            std::lock_guard<std::mutex> eventLock(eventMutex);
+            stats["event_queue_size"] = eventQueue.size();
+            stats["events_dropped"] = droppedEvents;
+        }
+        {
+            std::lock_guard<std::mutex> nameLock(nameCacheMutex);
+            stats["name_cache_size"] = nameCache.size();
+            stats["name_cache_hits"] = nameCacheHits;
+            stats["name_cache_misses"] = nameCacheMisses;
+        }
+        return stats;
     }
 };
 
-// Simple WASAPI loopback capture (system-wide)
+// Simple WASAPI loopback capture (system-wide).
+//
+// Uses the same architecture as QueueBasedProcessCapture in the capture
+// module: a dedicated capture thread drains WASAPI (event-driven where
+// SetEventHandle succeeds, 1ms polling otherwise) into a bounded chunk
+// queue, so a hiccup in the Python event loop can no longer overrun the
+// shared-mode buffer and silently lose audio. Chunk buffers are recycled
+// through a small free list, keeping the steady state allocation-free.
 class SimpleLoopbackCapture {
 private:
+    struct LoopbackChunk {
+        std::vector<float> data;
+        size_t frameCount = 0;
+        std::chrono::steady_clock::time_point timestamp;
+    };
+
     ComPtr<IAudioClient> audioClient;
     ComPtr<IAudioCaptureClient> captureClient;
-    std::vector<float> buffer;
-    std::mutex bufferMutex;
+    UINT32 channels = 2;
+    UINT32 sampleRate = 48000;
     bool isCapturing = false;
     bool comInitialized = false;
-    
+
+    std::thread captureThread;
+    std::atomic<bool> shouldStop{false};
+    bool eventDrivenMode = false;
+    HANDLE audioDataEvent = nullptr;
+    HANDLE stopEvent = nullptr;
+
+    std::deque<LoopbackChunk> chunkQueue;
+    std::vector<std::vector<float>> freeBuffers;
+    mutable std::mutex queueMutex;
+    std::condition_variable queueCv;
+    size_t maxQueueChunks = 1000;
+
+    std::atomic<size_t> totalFrames{0};
+    std::atomic<size_t> droppedChunks{0};
+    std::atomic<size_t> captureErrors{0};
+    std::atomic<size_t> eventSignals{0};
+
+    std::vector<float> acquireBuffer(size_t samples) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (!freeBuffers.empty()) {
+                std::vector<float> buf = std::move(freeBuffers.back());
+                freeBuffers.pop_back();
+                buf.resize(samples);
+                return buf;
+            }
+        }
+        return std::vector<float>(samples);
+    }
+
+    void pushChunk(LoopbackChunk&& chunk) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (chunkQueue.size() >= maxQueueChunks) {
+            // Bounded queue: recycle the oldest chunk's buffer and count
+            // the overrun instead of growing without limit
+            freeBuffers.push_back(std::move(chunkQueue.front().data));
+            chunkQueue.pop_front();
+            droppedChunks++;
+        }
+        chunkQueue.push_back(std::move(chunk));
+        queueCv.notify_one();
+    }
+
+    void captureLoop() {
+        DWORD taskIndex = 0;
+        HANDLE hTask = AvSetMmThreadCharacteristics(TEXT("Audio"), &taskIndex);
+
+        HRESULT hr = audioClient->Start();
+        if (FAILED(hr)) {
+            captureErrors++;
+            if (hTask) AvRevertMmThreadCharacteristics(hTask);
+            return;
+        }
+
+        while (!shouldStop) {
+            if (eventDrivenMode && audioDataEvent && stopEvent) {
+                // Classic endpoint loopback accepts SetEventHandle but is
+                // documented never to signal the capture event, so the
+                // timeout is the real pacing here: keep it at one engine
+                // period and drain on WAIT_TIMEOUT as well - the event,
+                // when it does fire, is only an optimization
+                HANDLE events[2] = { stopEvent, audioDataEvent };
+                DWORD waitResult = WaitForMultipleObjects(2, events, FALSE, 10);
+                if (waitResult == WAIT_OBJECT_0) {
+                    break;
+                } else if (waitResult == WAIT_OBJECT_0 + 1) {
+                    eventSignals++;
+                }
+            }
+
+            UINT32 packetLength = 0;
+            hr = captureClient->GetNextPacketSize(&packetLength);
+            if (FAILED(hr)) {
+                captureErrors++;
+                if (!eventDrivenMode) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                continue;
+            }
+
+            while (packetLength > 0 && !shouldStop) {
+                BYTE* data = nullptr;
+                UINT32 numFramesAvailable = 0;
+                DWORD flags = 0;
+
+                hr = captureClient->GetBuffer(
+                    &data, &numFramesAvailable, &flags, nullptr, nullptr);
+
+                if (SUCCEEDED(hr)) {
+                    LoopbackChunk chunk;
+                    chunk.data = acquireBuffer(numFramesAvailable * channels);
+                    chunk.frameCount = numFramesAvailable;
+                    chunk.timestamp = std::chrono::steady_clock::now();
+
+                    if (!(flags & AUDCLNT_BUFFERFLAGS_SILENT) && data) {
+                        std::memcpy(chunk.data.data(), data,
+                                    numFramesAvailable * channels * sizeof(float));
+                    } else {
+                        std::memset(chunk.data.data(), 0,
+                                    numFramesAvailable * channels * sizeof(float));
+                    }
+
+                    totalFrames += numFramesAvailable;
+                    pushChunk(std::move(chunk));
+
+                    captureClient->ReleaseBuffer(numFramesAvailable);
+                } else {
+                    captureErrors++;
+                }
+
+                hr = captureClient->GetNextPacketSize(&packetLength);
+                if (FAILED(hr)) {
+                    captureErrors++;
+                    break;
+                }
+            }
+
+            if (!eventDrivenMode) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        audioClient->Stop();
+        if (hTask) AvRevertMmThreadCharacteristics(hTask);
+    }
+
 public:
     SimpleLoopbackCapture() {
         HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
@@ -260,117 +912,218 @@ public:
             comInitialized = false;
         }
     }
-    
+
     ~SimpleLoopbackCapture() {
         Stop();
+        if (audioDataEvent) {
+            CloseHandle(audioDataEvent);
+            audioDataEvent = nullptr;
+        }
+        if (stopEvent) {
+            CloseHandle(stopEvent);
+            stopEvent = nullptr;
+        }
         if (comInitialized) {
             CoUninitialize();
         }
     }
-    
+
     bool Start() {
         if (isCapturing) return false;
-        
+
         HRESULT hr;
-        
+
         // Get default audio device
         ComPtr<IMMDeviceEnumerator> deviceEnumerator;
         hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr,
             CLSCTX_ALL, __uuidof(IMMDeviceEnumerator),
             reinterpret_cast<void**>(deviceEnumerator.GetAddressOf()));
-        
+
         if (FAILED(hr)) return false;
-        
+
         ComPtr<IMMDevice> device;
         hr = deviceEnumerator->GetDefaultAudioEndpoint(
             eRender, eConsole, &device);
-        
+
         if (FAILED(hr)) return false;
-        
+
         // Activate audio client
         hr = device->Activate(__uuidof(IAudioClient),
             CLSCTX_ALL, nullptr,
             reinterpret_cast<void**>(audioClient.GetAddressOf()));
-        
+
         if (FAILED(hr)) return false;
-        
+
         // Get mix format
         WAVEFORMATEX* format = nullptr;
         hr = audioClient->GetMixFormat(&format);
         if (FAILED(hr)) return false;
-        
-        // Initialize in loopback mode
+
+        channels = format->nChannels;
+        sampleRate = format->nSamplesPerSec;
+
+        // Try event-driven loopback first, fall back to polling
         hr = audioClient->Initialize(
             AUDCLNT_SHAREMODE_SHARED,
-            AUDCLNT_STREAMFLAGS_LOOPBACK,
+            AUDCLNT_STREAMFLAGS_LOOPBACK | AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
             0, 0, format, nullptr);
-        
+
+        eventDrivenMode = false;
+        if (SUCCEEDED(hr)) {
+            // Reuse event handles across Start()/Stop() cycles - only the
+            // destructor closes them, so creating fresh ones here would
+            // leak a pair per cycle
+            if (!audioDataEvent) {
+                audioDataEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+            }
+            if (!stopEvent) {
+                stopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+            }
+            if (audioDataEvent && stopEvent &&
+                SUCCEEDED(audioClient->SetEventHandle(audioDataEvent))) {
+                eventDrivenMode = true;
+            }
+        } else {
+            hr = audioClient->Initialize(
+                AUDCLNT_SHAREMODE_SHARED,
+                AUDCLNT_STREAMFLAGS_LOOPBACK,
+                0, 0, format, nullptr);
+        }
+
         CoTaskMemFree(format);
-        
+
         if (FAILED(hr)) return false;
-        
+
         // Get capture client
         hr = audioClient->GetService(__uuidof(IAudioCaptureClient),
             reinterpret_cast<void**>(captureClient.GetAddressOf()));
-        
-        if (FAILED(hr)) return false;
-        
-        // Start capture
-        hr = audioClient->Start();
+
         if (FAILED(hr)) return false;
-        
+
+        // Reset state and start the background capture thread
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            chunkQueue.clear();
+        }
+        totalFrames = 0;
+        droppedChunks = 0;
+        captureErrors = 0;
+        eventSignals = 0;
+        shouldStop = false;
+        if (stopEvent) ResetEvent(stopEvent);
+
+        captureThread = std::thread(&SimpleLoopbackCapture::captureLoop, this);
+
         isCapturing = true;
         return true;
     }
-    
+
     void Stop() {
-        if (isCapturing && audioClient) {
-            audioClient->Stop();
-            isCapturing = false;
+        if (!isCapturing) return;
+
+        shouldStop = true;
+        if (stopEvent) SetEvent(stopEvent);
+        queueCv.notify_all();
+
+        if (captureThread.joinable()) {
+            captureThread.join();
         }
+
+        captureClient.Reset();
+        audioClient.Reset();
+        isCapturing = false;
     }
-    
+
+    // Batched retrieval, same shape as QueueBasedProcessCapture's
+    // pop_chunks: a list of dicts with an (N, channels) float32 array
+    py::list PopChunks(size_t maxChunks = 10, int timeoutMs = 10) {
+        std::vector<LoopbackChunk> chunks;
+        {
+            // Waiting up to timeout_ms for chunks must not stall other
+            // Python threads
+            py::gil_scoped_release release;
+            std::unique_lock<std::mutex> lock(queueMutex);
+            auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(timeoutMs);
+            queueCv.wait_until(lock, deadline,
+                               [this] { return !chunkQueue.empty() || shouldStop.load(); });
+
+            while (!chunkQueue.empty() && chunks.size() < maxChunks) {
+                chunks.push_back(std::move(chunkQueue.front()));
+                chunkQueue.pop_front();
+            }
+        }
+
+        py::list result;
+        for (auto& chunk : chunks) {
+            py::array_t<float> arr({static_cast<py::ssize_t>(chunk.frameCount),
+                                    static_cast<py::ssize_t>(channels)});
+            auto ptr = static_cast<float*>(arr.mutable_unchecked<2>().mutable_data(0, 0));
+            std::memcpy(ptr, chunk.data.data(),
+                        chunk.frameCount * channels * sizeof(float));
+
+            py::dict chunkDict;
+            chunkDict["data"] = arr;
+            chunkDict["timestamp"] = std::chrono::duration_cast<std::chrono::microseconds>(
+                chunk.timestamp.time_since_epoch()).count();
+            result.append(chunkDict);
+
+            std::lock_guard<std::mutex> lock(queueMutex);
+            freeBuffers.push_back(std::move(chunk.data));
+        }
+
+        return result;
+    }
+
+    // Legacy API: drain everything queued into one flat interleaved
+    // array. Now backed by the thread-filled queue, so audio captured
+    // while Python was busy is retained instead of overrun.
     py::array_t<float> GetBuffer() {
-        if (!isCapturing || !captureClient) {
-            return py::array_t<float>(0);
+        std::vector<LoopbackChunk> chunks;
+        size_t totalSamples = 0;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            while (!chunkQueue.empty()) {
+                totalSamples += chunkQueue.front().frameCount * channels;
+                chunks.push_back(std::move(chunkQueue.front()));
+                chunkQueue.pop_front();
+            }
         }
-        
-        std::lock_guard<std::mutex> lock(bufferMutex);
-        buffer.clear();
-        
-        UINT32 packetLength = 0;
-        HRESULT hr = captureClient->GetNextPacketSize(&packetLength);
-        
-        while (SUCCEEDED(hr) && packetLength > 0) {
-            BYTE* data = nullptr;
-            UINT32 numFramesAvailable;
-            DWORD flags;
-            
-            hr = captureClient->GetBuffer(
-                &data, &numFramesAvailable, &flags,
-                nullptr, nullptr);
-            
-            if (SUCCEEDED(hr)) {
-                if (!(flags & AUDCLNT_BUFFERFLAGS_SILENT)) {
-                    // Assuming float format
-                    float* floatData = reinterpret_cast<float*>(data);
-                    buffer.insert(buffer.end(), 
-                        floatData, 
-                        floatData + numFramesAvailable * 2); // stereo
-                }
-                
-                captureClient->ReleaseBuffer(numFramesAvailable);
+
+        auto result = py::array_t<float>(totalSamples);
+        if (totalSamples > 0) {
+            auto ptr = static_cast<float*>(result.mutable_unchecked<1>().mutable_data(0));
+            for (auto& chunk : chunks) {
+                std::memcpy(ptr, chunk.data.data(),
+                            chunk.frameCount * channels * sizeof(float));
+                ptr += chunk.frameCount * channels;
+            }
+
+            std::lock_guard<std::mutex> lock(queueMutex);
+            for (auto& chunk : chunks) {
+                freeBuffers.push_back(std::move(chunk.data));
             }
-            
-            hr = captureClient->GetNextPacketSize(&packetLength);
         }
-        
-        auto result = py::array_t<float>(buffer.size());
-        auto ptr = static_cast<float*>(result.mutable_unchecked<1>().mutable_data(0));
-        std::copy(buffer.begin(), buffer.end(), ptr);
-        
+
         return result;
     }
+
+    py::dict GetMetrics() const {
+        py::dict metrics;
+        metrics["capturing"] = isCapturing;
+        metrics["event_driven"] = eventDrivenMode;
+        metrics["channels"] = channels;
+        metrics["sample_rate"] = sampleRate;
+        metrics["total_frames"] = totalFrames.load();
+        metrics["dropped_chunks"] = droppedChunks.load();
+        metrics["capture_errors"] = captureErrors.load();
+        metrics["event_signals"] = eventSignals.load();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            metrics["queue_size"] = chunkQueue.size();
+        }
+        return metrics;
+    }
 };
 
 PYBIND11_MODULE(core, m) {
@@ -387,19 +1140,51 @@ PYBIND11_MODULE(core, m) {
     py::class_<AudioSessionEnumerator>(m, "SessionEnumerator")
         .def(py::init<>())
         .def("enumerate_sessions", &AudioSessionEnumerator::EnumerateSessions,
-             "Enumerate all audio sessions")
+             py::call_guard<py::gil_scoped_release>(),
+             "Enumerate all audio sessions (walks every session on the\n"
+             "default device; GIL released)")
         .def("set_session_volume", &AudioSessionEnumerator::SetSessionVolume,
-             "Set volume for a specific process",
-             py::arg("process_id"), py::arg("volume"));
+             "Set volume for a specific process (O(1) against the session cache)",
+             py::arg("process_id"), py::arg("volume"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("apply_session_settings", &AudioSessionEnumerator::ApplySessionSettings,
+             py::arg("settings"),
+             "Apply a batch of volume/mute changes in a single cache pass.\n"
+             "settings is a list of dicts: {'pid': int, 'volume': float (optional),\n"
+             "'mute': bool (optional)}. Returns [{'pid', 'success'}] per entry.")
+        .def("refresh", &AudioSessionEnumerator::Refresh,
+             py::call_guard<py::gil_scoped_release>(),
+             "Force a full re-enumeration into the session cache")
+        .def("subscribe_events", &AudioSessionEnumerator::SubscribeEvents,
+             py::arg("enabled") = true,
+             py::call_guard<py::gil_scoped_release>(),
+             "Subscribe to push-based session events (created /\n"
+             "state_changed / volume_changed / disconnected) instead of\n"
+             "polling enumerate_sessions. Drain with pop_events().")
+        .def("pop_events", &AudioSessionEnumerator::PopEvents,
+             py::arg("max_events") = 64, py::arg("timeout_ms") = 100,
+             "Drain queued session events (dicts with type, pid,\n"
+             "timestamp and the change payload), waiting up to\n"
+             "timeout_ms for the first one. GIL released while waiting.")
+        .def("get_cache_stats", &AudioSessionEnumerator::GetCacheStats,
+             "Session-cache hit/miss counters and size");
     
     py::class_<SimpleLoopbackCapture>(m, "SimpleLoopback")
         .def(py::init<>())
         .def("start", &SimpleLoopbackCapture::Start,
-             "Start system-wide loopback capture")
+             py::call_guard<py::gil_scoped_release>(),
+             "Start system-wide loopback capture (background capture thread,\n"
+             "event-driven where supported)")
         .def("stop", &SimpleLoopbackCapture::Stop,
-             "Stop capture")
+             py::call_guard<py::gil_scoped_release>(),
+             "Stop capture (GIL released while joining the capture thread)")
         .def("get_buffer", &SimpleLoopbackCapture::GetBuffer,
-             "Get captured audio buffer");
+             "Drain all queued audio into one flat interleaved float32 array")
+        .def("pop_chunks", &SimpleLoopbackCapture::PopChunks,
+             py::arg("max_chunks") = 10, py::arg("timeout_ms") = 10,
+             "Pop queued chunks as dicts with an (N, channels) float32 array")
+        .def("get_metrics", &SimpleLoopbackCapture::GetMetrics,
+             "Capture metrics including dropped-chunk (overrun) counter");
     
     // Audio session state enum
     py::enum_<AudioSessionState>(m, "SessionState")
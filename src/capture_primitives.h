@@ -0,0 +1,617 @@
+// Capture pipeline primitives shared between pywac.capture and pywac._bench
+//
+// Everything in this header is pure C++ (plus pybind11 for metric dicts):
+// the chunk container, the two queue flavours, the buffer pool and the
+// lock-free histogram. Keeping them free of Windows/WASAPI dependencies
+// lets the benchmark module exercise the exact code the capture thread
+// runs, on any machine, without an audio device.
+
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+#include <vector>
+#include <queue>
+#include <map>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include <emmintrin.h>  // SSE2 - baseline on x64
+
+namespace py = pybind11;
+
+// Audio chunk structure
+struct AudioChunk {
+    std::vector<float> data;
+    size_t frameCount;
+    uint32_t channels;
+    bool silent;
+    bool gap;  // Run-length record for suppressed silence - no data
+    uint64_t sequence;  // Absolute frame index of the first frame since start
+    uint64_t devicePosition;  // Engine frame position of the first frame (from GetBuffer)
+    uint64_t qpcTime;   // QPC of the first frame in 100ns units (from GetBuffer)
+    std::chrono::steady_clock::time_point timestamp;
+
+    AudioChunk() : frameCount(0), channels(2), silent(false), gap(false),
+                   sequence(0), devicePosition(0), qpcTime(0) {}
+    AudioChunk(size_t frames) : data(frames * 2), frameCount(frames), channels(2),
+                                silent(false), gap(false), sequence(0),
+                                devicePosition(0), qpcTime(0) {
+        timestamp = std::chrono::steady_clock::now();
+    }
+};
+
+// Heap bytes a chunk's sample buffer is holding. Capacity rather than
+// size: pooled buffers keep their full allocation between uses, and
+// capacity is what the box actually pays for.
+inline size_t ChunkHeapBytes(const AudioChunk& chunk) {
+    return chunk.data.capacity() * sizeof(float);
+}
+
+// What push() does when the queue is full. Drops are never silent
+// corruption: every dropped chunk is counted, and the per-chunk frame
+// sequence lets the consumer locate and size the hole exactly.
+enum class DropPolicy {
+    DropOldest = 0,      // Keep the freshest audio (live monitoring)
+    DropNewest,          // Keep the contiguous past (recording)
+    BlockWithDeadline,   // Wait briefly for space, then drop newest
+    Decimate             // Keep every other chunk while saturated
+};
+
+// Thread-safe audio queue implementation
+class ThreadSafeAudioQueue {
+private:
+    std::queue<AudioChunk> queue;
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::condition_variable spaceCv;  // Signalled by pops, for BlockWithDeadline
+
+    size_t maxSize;
+    size_t totalChunks = 0;
+    size_t droppedChunks = 0;
+    size_t heldBytes = 0;   // Sample-buffer bytes of queued chunks
+    size_t peakDepth = 0;   // High-water queue depth since clear()
+    std::atomic<bool> closed{false};
+
+    DropPolicy policy = DropPolicy::DropOldest;
+    int blockDeadlineMs = 5;
+    bool decimatePhase = false;
+
+public:
+    ThreadSafeAudioQueue(size_t max_size = 1000) : maxSize(max_size) {}
+
+    void setDropPolicy(DropPolicy p, int blockMs = 5) {
+        std::lock_guard<std::mutex> lock(mutex);
+        policy = p;
+        blockDeadlineMs = blockMs;
+        decimatePhase = false;
+    }
+
+    // Producer side - called from C++ capture thread
+    bool push(AudioChunk&& chunk) {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (closed) return false;
+
+        if (queue.size() >= maxSize) {
+            switch (policy) {
+                case DropPolicy::DropOldest:
+                    heldBytes -= ChunkHeapBytes(queue.front());
+                    queue.pop();
+                    droppedChunks++;
+                    break;
+                case DropPolicy::DropNewest:
+                    droppedChunks++;
+                    return false;
+                case DropPolicy::BlockWithDeadline: {
+                    auto deadline = std::chrono::steady_clock::now() +
+                                    std::chrono::milliseconds(blockDeadlineMs);
+                    spaceCv.wait_until(lock, deadline,
+                        [this] { return queue.size() < maxSize || closed; });
+                    if (closed) return false;
+                    if (queue.size() >= maxSize) {
+                        // Deadline passed with no space: shed the newest
+                        droppedChunks++;
+                        return false;
+                    }
+                    break;
+                }
+                case DropPolicy::Decimate:
+                    // Alternate between shedding the incoming chunk and
+                    // the oldest queued one, halving rate evenly across
+                    // old and new audio while saturated
+                    decimatePhase = !decimatePhase;
+                    if (decimatePhase) {
+                        droppedChunks++;
+                        return false;
+                    }
+                    heldBytes -= ChunkHeapBytes(queue.front());
+                    queue.pop();
+                    droppedChunks++;
+                    break;
+            }
+        }
+
+        heldBytes += ChunkHeapBytes(chunk);
+        queue.push(std::move(chunk));
+        totalChunks++;
+        if (queue.size() > peakDepth) peakDepth = queue.size();
+
+        cv.notify_one();
+        return true;
+    }
+
+    // Consumer side - called from Python
+    std::vector<AudioChunk> popBatch(size_t maxChunks = 10, int timeoutMs = 10) {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::vector<AudioChunk> result;
+
+        // Wait for data or timeout
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        cv.wait_until(lock, deadline, [this] { return !queue.empty() || closed; });
+
+        // Collect up to maxChunks
+        while (!queue.empty() && result.size() < maxChunks) {
+            heldBytes -= ChunkHeapBytes(queue.front());
+            result.push_back(std::move(queue.front()));
+            queue.pop();
+        }
+
+        if (!result.empty()) {
+            spaceCv.notify_all();
+        }
+
+        return result;
+    }
+
+    // Get single chunk (for compatibility)
+    std::unique_ptr<AudioChunk> pop(int timeoutMs = 10) {
+        auto batch = popBatch(1, timeoutMs);
+        if (batch.empty()) {
+            return nullptr;
+        }
+        return std::make_unique<AudioChunk>(std::move(batch[0]));
+    }
+
+    void clear() {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::queue<AudioChunk> empty;
+        std::swap(queue, empty);
+        heldBytes = 0;
+        peakDepth = 0;
+        // Reopen a queue that close() shut: clear() marks the start of a
+        // new run, so pushes must be accepted again
+        closed = false;
+        spaceCv.notify_all();
+    }
+
+    size_t size() const {
+        std::unique_lock<std::mutex> lock(mutex);
+        return queue.size();
+    }
+
+    bool empty() const {
+        std::unique_lock<std::mutex> lock(mutex);
+        return queue.empty();
+    }
+
+    void close() {
+        std::unique_lock<std::mutex> lock(mutex);
+        closed = true;
+        cv.notify_all();
+        spaceCv.notify_all();
+    }
+
+    std::map<std::string, size_t> getStats() const {
+        std::unique_lock<std::mutex> lock(mutex);
+        return {
+            {"queue_size", queue.size()},
+            {"total_chunks", totalChunks},
+            {"dropped_chunks", droppedChunks},
+            {"held_bytes", heldBytes},
+            {"peak_depth", peakDepth}
+        };
+    }
+};
+
+// Reusable chunk-buffer pool. AudioChunk still owns a std::vector<float>,
+// but in steady state the vector's storage cycles through this pool
+// instead of round-tripping the heap 100 times a second per stream.
+// acquire() uses try_lock so the capture thread can never block here:
+// if the consumer happens to hold the free-list lock, we fall back to a
+// plain allocation and count it so the pool can be sized from metrics.
+class ChunkBufferPool {
+private:
+    std::vector<std::vector<float>> freeList;
+    mutable std::mutex mutex;
+    size_t poolSize;
+    std::atomic<size_t> allocFallbacks{0};
+    std::atomic<size_t> totalAcquires{0};
+    std::atomic<size_t> outstanding{0};
+
+public:
+    ChunkBufferPool(size_t pool_size = 64, size_t samplesPerBuffer = 960)
+        : poolSize(pool_size) {
+        // Prewarm so the first seconds of capture are allocation-free too
+        freeList.reserve(poolSize);
+        for (size_t i = 0; i < poolSize; i++) {
+            freeList.emplace_back(samplesPerBuffer);
+        }
+    }
+
+    std::vector<float> acquire(size_t samples) {
+        totalAcquires.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+            if (lock.owns_lock() && !freeList.empty()) {
+                std::vector<float> buf = std::move(freeList.back());
+                freeList.pop_back();
+                lock.unlock();
+
+                // Capacity is retained from previous use, so this resize
+                // does not allocate for the common fixed chunk size
+                buf.resize(samples);
+                outstanding.fetch_add(1, std::memory_order_relaxed);
+                return buf;
+            }
+        }
+
+        allocFallbacks.fetch_add(1, std::memory_order_relaxed);
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+        return std::vector<float>(samples);
+    }
+
+    void release(std::vector<float>&& buf) {
+        if (buf.capacity() == 0) return;
+        if (outstanding.load(std::memory_order_relaxed) > 0) {
+            outstanding.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (freeList.size() < poolSize) {
+            freeList.push_back(std::move(buf));
+        }
+        // Otherwise the buffer is simply freed - the pool never grows
+        // beyond its configured size
+    }
+
+    std::map<std::string, size_t> getStats() const {
+        size_t freeCount;
+        size_t freeBytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeCount = freeList.size();
+            for (const auto& buffer : freeList) {
+                freeBytes += buffer.capacity() * sizeof(float);
+            }
+        }
+        return {
+            {"pool_size", poolSize},
+            {"pool_free", freeCount},
+            {"pool_free_bytes", freeBytes},
+            {"pool_outstanding", outstanding.load(std::memory_order_relaxed)},
+            {"pool_acquires", totalAcquires.load(std::memory_order_relaxed)},
+            {"pool_alloc_fallbacks", allocFallbacks.load(std::memory_order_relaxed)}
+        };
+    }
+};
+
+// Keeps a chunk buffer (and its pool) alive for as long as a numpy array
+// aliasing it exists. When Python garbage-collects the array the capsule
+// destructor runs and the buffer goes back to the pool - zero copies on
+// the way out, and the pool cannot be destroyed out from under a view.
+struct PooledBufferHolder {
+    std::vector<float> data;
+    std::shared_ptr<ChunkBufferPool> pool;
+};
+
+// Lock-free single-producer/single-consumer chunk ring.
+// The capture thread is the only producer and Python is the only consumer,
+// so acquire/release ordering on the head/tail indexes is sufficient --
+// no mutex, no condition variable. push() never blocks: if the ring is
+// full the incoming chunk is counted as dropped and discarded, keeping
+// the contiguous past intact. Capacity is rounded up to a power of two
+// so index wrapping is a mask instead of a modulo.
+class LockFreeChunkRing {
+private:
+    std::vector<AudioChunk> slots;
+    size_t capacityMask = 0;
+    std::atomic<size_t> head{0};  // Next slot to write (producer only)
+    std::atomic<size_t> tail{0};  // Next slot to read (consumer only)
+    std::atomic<size_t> totalChunks{0};
+    std::atomic<size_t> droppedChunks{0};
+    std::atomic<size_t> heldBytes{0};  // Sample-buffer bytes of queued chunks
+    std::atomic<size_t> peakDepth{0};  // High-water depth; producer-written
+    std::atomic<bool> closed{false};
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+public:
+    LockFreeChunkRing(size_t capacity = 1000) {
+        size_t cap = roundUpPowerOfTwo(capacity < 2 ? 2 : capacity);
+        slots.resize(cap);
+        capacityMask = cap - 1;
+    }
+
+    size_t capacity() const { return capacityMask + 1; }
+
+    // Producer side - called from C++ capture thread, never blocks
+    bool push(AudioChunk&& chunk) {
+        if (closed.load(std::memory_order_relaxed)) return false;
+
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_acquire);
+
+        if (h - t > capacityMask) {
+            // Ring full - drop the newest chunk rather than stall the
+            // capture thread
+            droppedChunks.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        heldBytes.fetch_add(ChunkHeapBytes(chunk), std::memory_order_relaxed);
+        slots[h & capacityMask] = std::move(chunk);
+        head.store(h + 1, std::memory_order_release);
+        totalChunks.fetch_add(1, std::memory_order_relaxed);
+        size_t depth = h + 1 - t;
+        if (depth > peakDepth.load(std::memory_order_relaxed)) {
+            peakDepth.store(depth, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Consumer side - called from Python, never blocks
+    bool pop(AudioChunk& out) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+
+        if (t == h) return false;
+
+        out = std::move(slots[t & capacityMask]);
+        tail.store(t + 1, std::memory_order_release);
+        heldBytes.fetch_sub(ChunkHeapBytes(out), std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer-side batched pop with a deadline. There is no condition
+    // variable to wait on, so an empty ring is polled at 1ms granularity
+    // until the timeout expires - still far cheaper than blocking the
+    // producer ever was.
+    std::vector<AudioChunk> popBatch(size_t maxChunks = 10, int timeoutMs = 10) {
+        std::vector<AudioChunk> result;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+        while (result.size() < maxChunks) {
+            AudioChunk chunk;
+            if (pop(chunk)) {
+                result.push_back(std::move(chunk));
+                continue;
+            }
+            if (!result.empty() || closed.load(std::memory_order_relaxed)) break;
+            if (std::chrono::steady_clock::now() >= deadline) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return result;
+    }
+
+    void clear() {
+        AudioChunk discard;
+        while (pop(discard)) {}
+        peakDepth.store(0, std::memory_order_relaxed);
+        // Reopen after close(): clear() marks the start of a new run
+        closed.store(false, std::memory_order_release);
+    }
+
+    size_t size() const {
+        size_t t = tail.load(std::memory_order_acquire);
+        size_t h = head.load(std::memory_order_acquire);
+        return h - t;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    void close() {
+        closed = true;
+    }
+
+    std::map<std::string, size_t> getStats() const {
+        return {
+            {"queue_size", size()},
+            {"total_chunks", totalChunks.load(std::memory_order_relaxed)},
+            {"dropped_chunks", droppedChunks.load(std::memory_order_relaxed)},
+            {"held_bytes", heldBytes.load(std::memory_order_relaxed)},
+            {"peak_depth", peakDepth.load(std::memory_order_relaxed)}
+        };
+    }
+};
+
+// --- SIMD kernels -----------------------------------------------------
+// SSE2 is the x64 baseline, so these run everywhere this module builds.
+// They are applied on buffers that are already hot in cache from the
+// capture-loop memcpy, so the extra passes are effectively free in
+// memory bandwidth.
+
+// Clamp and scale float32 samples to int16, 8 samples per iteration
+inline void ConvertFloat32ToInt16(const float* src, int16_t* dst, size_t samples) {
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    const __m128 maxVal = _mm_set1_ps(1.0f);
+    const __m128 minVal = _mm_set1_ps(-1.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        __m128 a = _mm_loadu_ps(src + i);
+        __m128 b = _mm_loadu_ps(src + i + 4);
+        a = _mm_mul_ps(_mm_max_ps(_mm_min_ps(a, maxVal), minVal), scale);
+        b = _mm_mul_ps(_mm_max_ps(_mm_min_ps(b, maxVal), minVal), scale);
+        __m128i ia = _mm_cvtps_epi32(a);
+        __m128i ib = _mm_cvtps_epi32(b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(ia, ib));
+    }
+
+    for (; i < samples; i++) {
+        float s = src[i];
+        if (s > 1.0f) s = 1.0f;
+        if (s < -1.0f) s = -1.0f;
+        dst[i] = static_cast<int16_t>(s * 32767.0f);
+    }
+}
+
+// In-place gain, 4 samples per iteration
+inline void ApplyGain(float* data, size_t samples, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+
+    size_t i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+    }
+    for (; i < samples; i++) {
+        data[i] *= gain;
+    }
+}
+
+// Average interleaved stereo down to mono, 4 frames per iteration
+inline void DownmixStereoToMono(const float* src, float* dst, size_t frames) {
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(src + 2 * i);      // L0 R0 L1 R1
+        __m128 b = _mm_loadu_ps(src + 2 * i + 4);  // L2 R2 L3 R3
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_add_ps(left, right), half));
+    }
+    for (; i < frames; i++) {
+        dst[i] = (src[2 * i] + src[2 * i + 1]) * 0.5f;
+    }
+}
+
+// dst += src * gain, 4 samples per iteration. The mixer's inner loop:
+// one fused pass per stream instead of a scale pass plus an add pass.
+inline void MixAccumulate(float* dst, const float* src, size_t samples, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+
+    size_t i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        __m128 d = _mm_loadu_ps(dst + i);
+        __m128 s = _mm_loadu_ps(src + i);
+        _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g)));
+    }
+    for (; i < samples; i++) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+// Absolute peak and sum of squares in one pass, 4 samples per iteration.
+// Feeds the capture-thread level meters: one scan of a buffer that is
+// already in cache replaces shipping the whole chunk to Python just to
+// run np.abs().max().
+inline void PeakAndSumSquares(const float* src, size_t samples,
+                              float& peak, double& sumSquares) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 vpeak = _mm_setzero_ps();
+    __m128 vsum = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        __m128 v = _mm_loadu_ps(src + i);
+        vpeak = _mm_max_ps(vpeak, _mm_andnot_ps(signMask, v));
+        vsum = _mm_add_ps(vsum, _mm_mul_ps(v, v));
+    }
+
+    float peaks[4], sums[4];
+    _mm_storeu_ps(peaks, vpeak);
+    _mm_storeu_ps(sums, vsum);
+    float p = peaks[0];
+    if (peaks[1] > p) p = peaks[1];
+    if (peaks[2] > p) p = peaks[2];
+    if (peaks[3] > p) p = peaks[3];
+    double s = static_cast<double>(sums[0]) + sums[1] + sums[2] + sums[3];
+
+    for (; i < samples; i++) {
+        float v = src[i];
+        float a = v < 0.0f ? -v : v;
+        if (a > p) p = a;
+        s += static_cast<double>(v) * v;
+    }
+
+    peak = p;
+    sumSquares = s;
+}
+
+// Lock-free histogram with power-of-two buckets, for hot-path latency
+// instrumentation. record() is two relaxed atomic increments plus a
+// compare-exchange for the max - no locks, no allocation - so it is safe
+// to call from the capture loop. Percentiles are reported as the upper
+// bound of the bucket the percentile falls in.
+class LatencyHistogram {
+private:
+    static const int kBuckets = 32;
+    std::atomic<uint64_t> buckets[kBuckets];
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> maxValue{0};
+
+    static unsigned bucketIndex(uint64_t value) {
+        unsigned idx = 0;
+        while (idx < kBuckets - 1 && (1ull << (idx + 1)) <= value) idx++;
+        return idx;
+    }
+
+public:
+    LatencyHistogram() {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    }
+
+    void record(uint64_t value) {
+        buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t prev = maxValue.load(std::memory_order_relaxed);
+        while (value > prev &&
+               !maxValue.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void reset() {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+        count.store(0, std::memory_order_relaxed);
+        maxValue.store(0, std::memory_order_relaxed);
+    }
+
+    py::dict snapshot() const {
+        uint64_t total = count.load(std::memory_order_relaxed);
+
+        auto percentile = [&](double p) -> uint64_t {
+            if (total == 0) return 0;
+            uint64_t target = static_cast<uint64_t>(p * total);
+            if (target >= total) target = total - 1;
+            uint64_t cumulative = 0;
+            for (int i = 0; i < kBuckets; i++) {
+                cumulative += buckets[i].load(std::memory_order_relaxed);
+                if (cumulative > target) {
+                    return 1ull << (i + 1);  // Bucket upper bound
+                }
+            }
+            return maxValue.load(std::memory_order_relaxed);
+        };
+
+        py::dict d;
+        d["count"] = total;
+        d["p50"] = percentile(0.50);
+        d["p95"] = percentile(0.95);
+        d["p99"] = percentile(0.99);
+        d["max"] = maxValue.load(std::memory_order_relaxed);
+        return d;
+    }
+};
@@ -18,6 +18,12 @@
 #include <combaseapi.h>
 #include <psapi.h>
 
+// Media Foundation (compressed recording sink)
+#include <mfapi.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+#include <mferror.h>
+
 #include <wrl/implements.h>
 #include <wrl/client.h>
 
@@ -32,6 +38,14 @@
 #include <iomanip>
 #include <chrono>
 #include <memory>
+#include <cstdio>
+#include <cstdint>
+#include <emmintrin.h>  // SSE2 - baseline on x64
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "capture_primitives.h"
 
 using Microsoft::WRL::RuntimeClass;
 using Microsoft::WRL::RuntimeClassFlags;
@@ -51,112 +65,6 @@ namespace py = pybind11;
 #define AUDCLNT_BUFFERFLAGS_SILENT 0x2
 #endif
 
-// Audio chunk structure
-struct AudioChunk {
-    std::vector<float> data;
-    size_t frameCount;
-    bool silent;
-    std::chrono::steady_clock::time_point timestamp;
-    
-    AudioChunk() : frameCount(0), silent(false) {}
-    AudioChunk(size_t frames) : data(frames * 2), frameCount(frames), silent(false) {
-        timestamp = std::chrono::steady_clock::now();
-    }
-};
-
-// Thread-safe audio queue implementation
-class ThreadSafeAudioQueue {
-private:
-    std::queue<AudioChunk> queue;
-    mutable std::mutex mutex;
-    std::condition_variable cv;
-    
-    size_t maxSize;
-    size_t totalChunks = 0;
-    size_t droppedChunks = 0;
-    std::atomic<bool> closed{false};
-    
-public:
-    ThreadSafeAudioQueue(size_t max_size = 1000) : maxSize(max_size) {}
-    
-    // Producer side - called from C++ capture thread
-    bool push(AudioChunk&& chunk) {
-        std::unique_lock<std::mutex> lock(mutex);
-        
-        if (closed) return false;
-        
-        // Drop oldest if queue is full
-        if (queue.size() >= maxSize) {
-            queue.pop();
-            droppedChunks++;
-        }
-        
-        queue.push(std::move(chunk));
-        totalChunks++;
-        
-        cv.notify_one();
-        return true;
-    }
-    
-    // Consumer side - called from Python
-    std::vector<AudioChunk> popBatch(size_t maxChunks = 10, int timeoutMs = 10) {
-        std::unique_lock<std::mutex> lock(mutex);
-        std::vector<AudioChunk> result;
-        
-        // Wait for data or timeout
-        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
-        cv.wait_until(lock, deadline, [this] { return !queue.empty() || closed; });
-        
-        // Collect up to maxChunks
-        while (!queue.empty() && result.size() < maxChunks) {
-            result.push_back(std::move(queue.front()));
-            queue.pop();
-        }
-        
-        return result;
-    }
-    
-    // Get single chunk (for compatibility)
-    std::unique_ptr<AudioChunk> pop(int timeoutMs = 10) {
-        auto batch = popBatch(1, timeoutMs);
-        if (batch.empty()) {
-            return nullptr;
-        }
-        return std::make_unique<AudioChunk>(std::move(batch[0]));
-    }
-    
-    void clear() {
-        std::unique_lock<std::mutex> lock(mutex);
-        std::queue<AudioChunk> empty;
-        std::swap(queue, empty);
-    }
-    
-    size_t size() const {
-        std::unique_lock<std::mutex> lock(mutex);
-        return queue.size();
-    }
-    
-    bool empty() const {
-        std::unique_lock<std::mutex> lock(mutex);
-        return queue.empty();
-    }
-    
-    void close() {
-        std::unique_lock<std::mutex> lock(mutex);
-        closed = true;
-        cv.notify_all();
-    }
-    
-    std::map<std::string, size_t> getStats() const {
-        std::unique_lock<std::mutex> lock(mutex);
-        return {
-            {"queue_size", queue.size()},
-            {"total_chunks", totalChunks},
-            {"dropped_chunks", droppedChunks}
-        };
-    }
-};
-
 // Process information class
 class ProcessInfo {
 public:
@@ -196,14 +104,268 @@ public:
         return S_OK;
     }
     
-    void Wait() {
+    // Bounded wait; returns false on timeout. The handler is refcounted
+    // by the async operation, so abandoning the wait is safe - a late
+    // completion lands in an object that is still alive.
+    bool WaitFor(int timeoutMs) {
         std::unique_lock<std::mutex> lock(mtx);
-        cv.wait(lock, [this] { return completed; });
+        return cv.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                           [this] { return completed; });
+    }
+};
+
+// Synchronously activate a process-loopback IAudioClient for a PID,
+// bounded by timeoutMs - the callers (watchdog recovery on the capture
+// thread, engine addStream) must never wedge on a hung audio service.
+// Shared by QueueBasedProcessCapture and MultiProcessCaptureEngine.
+// With excludeTree=true the stream carries everything EXCEPT the target
+// process tree - one stream instead of one per non-excluded process.
+static bool ActivateProcessLoopbackClient(DWORD processId, ComPtr<IAudioClient>& outClient,
+                                          bool excludeTree = false,
+                                          int timeoutMs = 10000) {
+    AUDIOCLIENT_ACTIVATION_PARAMS activationParams = {};
+    activationParams.ActivationType = AUDIOCLIENT_ACTIVATION_TYPE_PROCESS_LOOPBACK;
+    activationParams.ProcessLoopbackParams.ProcessLoopbackMode = excludeTree
+        ? PROCESS_LOOPBACK_MODE_EXCLUDE_TARGET_PROCESS_TREE
+        : PROCESS_LOOPBACK_MODE_INCLUDE_TARGET_PROCESS_TREE;
+    activationParams.ProcessLoopbackParams.TargetProcessId = processId;
+
+    PROPVARIANT activateParams = {};
+    activateParams.vt = VT_BLOB;
+    activateParams.blob.cbSize = sizeof(activationParams);
+    activateParams.blob.pBlobData = reinterpret_cast<BYTE*>(&activationParams);
+
+    ComPtr<CompletionHandler> completionHandler = Microsoft::WRL::Make<CompletionHandler>();
+    ComPtr<IActivateAudioInterfaceAsyncOperation> asyncOp;
+
+    HRESULT hr = ActivateAudioInterfaceAsync(
+        VIRTUAL_AUDIO_DEVICE_PROCESS_LOOPBACK,
+        __uuidof(IAudioClient),
+        &activateParams,
+        completionHandler.Get(),
+        &asyncOp
+    );
+
+    if (FAILED(hr)) {
+        std::cerr << "ActivateAudioInterfaceAsync failed: 0x" << std::hex << hr << std::endl;
+        return false;
+    }
+
+    // Bounded wait, same pattern as start(): abandoning is safe because
+    // the async operation holds its own reference to the handler
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeoutMs);
+    while (!completionHandler->WaitFor(50)) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            std::cerr << "Audio activation timed out after " << std::dec
+                      << timeoutMs << "ms" << std::endl;
+            return false;
+        }
+    }
+
+    if (FAILED(completionHandler->activateResult)) {
+        std::cerr << "Audio activation failed: 0x" << std::hex
+                  << completionHandler->activateResult << std::endl;
+        return false;
+    }
+
+    outClient = completionHandler->audioClient;
+    return true;
+}
+
+// Fixed format for Process Loopback (GetMixFormat returns E_NOTIMPL)
+static WAVEFORMATEX ProcessLoopbackFormat() {
+    WAVEFORMATEX format = {};
+    format.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+    format.nChannels = 2;
+    format.nSamplesPerSec = 48000;
+    format.wBitsPerSample = 32;
+    format.nBlockAlign = format.nChannels * format.wBitsPerSample / 8;
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+    format.cbSize = 0;
+    return format;
+}
+
+// Write a canonical 44-byte WAV header. dataBytes may be a placeholder;
+// the recording sink rewrites the header once the final size is known.
+static void WriteWavHeader(FILE* file, uint16_t formatTag, uint16_t channels,
+                           uint32_t sampleRate, uint16_t bitsPerSample,
+                           uint32_t dataBytes) {
+    uint16_t blockAlign = channels * bitsPerSample / 8;
+    uint32_t byteRate = sampleRate * blockAlign;
+    uint32_t riffSize = 36 + dataBytes;
+
+    fwrite("RIFF", 1, 4, file);
+    fwrite(&riffSize, 4, 1, file);
+    fwrite("WAVE", 1, 4, file);
+    fwrite("fmt ", 1, 4, file);
+    uint32_t fmtSize = 16;
+    fwrite(&fmtSize, 4, 1, file);
+    fwrite(&formatTag, 2, 1, file);
+    fwrite(&channels, 2, 1, file);
+    fwrite(&sampleRate, 4, 1, file);
+    fwrite(&byteRate, 4, 1, file);
+    fwrite(&blockAlign, 2, 1, file);
+    fwrite(&bitsPerSample, 2, 1, file);
+    fwrite("data", 1, 4, file);
+    fwrite(&dataBytes, 4, 1, file);
+}
+
+// Shared-memory ring layout for cross-process capture delivery. The
+// writer publishes progress through the atomic frame counter with
+// release ordering; readers track their own cursor and detect overruns
+// from the counter alone, so there is no cross-process locking.
+// std::atomic<uint64_t> is lock-free on x64, which makes it safe to
+// place in a shared section mapped by both sides.
+struct ShmRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t channels;
+    uint32_t sampleRate;
+    uint64_t capacityFrames;
+    std::atomic<uint64_t> totalFramesWritten;
+    uint64_t reserved[4];
+    // Followed immediately by float data[capacityFrames * channels]
+};
+
+static const uint32_t kShmMagic = 0x43415750;  // 'PWAC'
+static const uint32_t kShmVersion = 1;
+
+// Windowed-sinc polyphase resampler for rational rate conversion
+// (48000 -> 16000 for speech models being the motivating case). All
+// filter tables are precomputed at construction - and stored reversed
+// per phase, so the inner loop is a straight multiply-accumulate over
+// two ascending arrays that vectorizes cleanly.
+class PolyphaseResampler {
+private:
+    uint32_t channels;
+    uint32_t L = 1;  // Upsample factor
+    uint32_t M = 1;  // Downsample factor
+    int taps;        // Taps per phase
+    std::vector<float> coeffs;       // L phases x taps, reversed per phase
+    std::vector<float> inputBuffer;  // Interleaved history + pending input
+    uint64_t bufferStartFrame = 0;
+    uint64_t nextOutputFrame = 0;
+
+    static uint32_t gcd(uint32_t a, uint32_t b) {
+        while (b) {
+            uint32_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+public:
+    PolyphaseResampler(uint32_t inRate, uint32_t outRate, uint32_t numChannels,
+                       int tapsPerPhase = 32)
+        : channels(numChannels), taps(tapsPerPhase) {
+        const double kPi = 3.14159265358979323846;
+
+        uint32_t g = gcd(inRate, outRate);
+        L = outRate / g;
+        M = inRate / g;
+
+        // Blackman-windowed sinc prototype, cut off at the narrower of
+        // the two Nyquists, amplitude-compensated by L for the zero
+        // stuffing
+        const int totalTaps = taps * static_cast<int>(L);
+        const double fc = 1.0 / (2.0 * (std::max)(L, M));
+        const double center = (totalTaps - 1) / 2.0;
+
+        coeffs.assign(static_cast<size_t>(L) * taps, 0.0f);
+        for (int n = 0; n < totalTaps; n++) {
+            double x = n - center;
+            double sinc = (x == 0.0) ? 2.0 * fc
+                                     : std::sin(2.0 * kPi * fc * x) / (kPi * x);
+            double w = 0.42 - 0.5 * std::cos(2.0 * kPi * n / (totalTaps - 1))
+                            + 0.08 * std::cos(4.0 * kPi * n / (totalTaps - 1));
+            // Phase p owns prototype taps h[p + L*k]; store them reversed
+            // so the convolution walks input memory forward
+            size_t phase = n % L;
+            size_t k = n / L;
+            coeffs[phase * taps + (taps - 1 - k)] = static_cast<float>(sinc * w * L);
+        }
+    }
+
+    uint32_t outputFramesPerInput(size_t inFrames) const {
+        return static_cast<uint32_t>((inFrames * L) / M + 1);
+    }
+
+    // Resample interleaved input, appending interleaved output. Carries
+    // filter history across calls, so chunk boundaries are seamless.
+    void process(const float* input, size_t inFrames, std::vector<float>& output) {
+        inputBuffer.insert(inputBuffer.end(), input, input + inFrames * channels);
+        uint64_t availableEnd = bufferStartFrame + inputBuffer.size() / channels;
+
+        while (true) {
+            uint64_t inIdx = (nextOutputFrame * M) / L;
+            uint32_t phase = static_cast<uint32_t>((nextOutputFrame * M) % L);
+            if (inIdx >= availableEnd) break;
+
+            const float* h = &coeffs[static_cast<size_t>(phase) * taps];
+
+            if (channels == 1 && inIdx >= bufferStartFrame + taps - 1) {
+                // Contiguous mono fast path: SSE over the tap window
+                const float* x = &inputBuffer[static_cast<size_t>(
+                    inIdx - (taps - 1) - bufferStartFrame)];
+                __m128 acc4 = _mm_setzero_ps();
+                int k = 0;
+                for (; k + 4 <= taps; k += 4) {
+                    acc4 = _mm_add_ps(acc4,
+                        _mm_mul_ps(_mm_loadu_ps(h + k), _mm_loadu_ps(x + k)));
+                }
+                float lanes[4];
+                _mm_storeu_ps(lanes, acc4);
+                float acc = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+                for (; k < taps; k++) {
+                    acc += h[k] * x[k];
+                }
+                output.push_back(acc);
+            } else {
+                // Generic path (interleaved channels, or start-of-stream
+                // where the window still reaches into implicit zeros)
+                for (uint32_t c = 0; c < channels; c++) {
+                    float acc = 0.0f;
+                    for (int k = 0; k < taps; k++) {
+                        int64_t frame = static_cast<int64_t>(inIdx) - (taps - 1) + k;
+                        if (frame < static_cast<int64_t>(bufferStartFrame)) continue;
+                        acc += h[k] * inputBuffer[static_cast<size_t>(
+                            frame - bufferStartFrame) * channels + c];
+                    }
+                    output.push_back(acc);
+                }
+            }
+
+            nextOutputFrame++;
+        }
+
+        // Drop input frames no future output window can reach
+        uint64_t nextInIdx = (nextOutputFrame * M) / L;
+        uint64_t keepFrom = (nextInIdx >= static_cast<uint64_t>(taps - 1))
+            ? nextInIdx - (taps - 1) : 0;
+        if (keepFrom > bufferStartFrame) {
+            size_t dropFrames = static_cast<size_t>(keepFrom - bufferStartFrame);
+            inputBuffer.erase(inputBuffer.begin(),
+                              inputBuffer.begin() + dropFrames * channels);
+            bufferStartFrame = keepFrom;
+        }
     }
 };
 
+// Registry of live capture instances for get_resource_summary(); entries
+// are added in the constructor and removed first thing in the destructor,
+// so anything reachable through the registry lock is fully alive
+class QueueBasedProcessCapture;
+static std::mutex g_captureRegistryMutex;
+static std::vector<QueueBasedProcessCapture*> g_captureRegistry;
+
 // Queue-based process capture class
 class QueueBasedProcessCapture {
+    // The mixer drains capture queues and recycles buffers directly in
+    // C++, bypassing the Python-facing pop path
+    friend class StreamMixer;
+
 private:
     ComPtr<IAudioClient> audioClient;
     ComPtr<IAudioCaptureClient> captureClient;
@@ -212,15 +374,98 @@ private:
     std::thread captureThread;
     std::atomic<bool> capturing{false};
     std::atomic<bool> shouldStop{false};
-    
+
+    // Asynchronous start: activation and Initialize run on a worker
+    // thread so the caller never blocks; wait_ready() observes the
+    // outcome. cancelRequested also aborts the blocking start() path.
+    enum StartState { kStartIdle = 0, kStartActivating, kStartReady,
+                      kStartFailed, kStartCancelled };
+    std::thread asyncStartThread;
+    std::atomic<int> startState{kStartIdle};
+    std::atomic<bool> cancelRequested{false};
+    std::mutex startStateMutex;
+    std::condition_variable startStateCv;
+
+    void setStartState(int state) {
+        {
+            std::lock_guard<std::mutex> lock(startStateMutex);
+            startState.store(state);
+        }
+        startStateCv.notify_all();
+    }
+
+    // Warm-standby slots: threads parked with their COM apartment
+    // already initialized, so start() binds one with a SetEvent instead
+    // of paying thread creation and CoInitializeEx on the attach path.
+    // Activation itself is baked to a PID and cannot be prewarmed; the
+    // attach-latency metric measures what remains.
+    struct StandbySlot {
+        HANDLE goEvent = nullptr;
+        std::thread thread;
+        std::atomic<bool> shutdown{false};
+    };
+    std::vector<std::unique_ptr<StandbySlot>> standbySlots;
+    std::vector<std::unique_ptr<StandbySlot>> retiredSlots;  // goEvent closed in dtor
+    mutable std::mutex standbyMutex;
+    std::atomic<size_t> standbyBinds{0};
+
+    // start()-entry to first-chunk-in-queue latency, for verifying
+    // prewarmed attach times
+    std::chrono::steady_clock::time_point startCallTime;
+    std::atomic<bool> awaitingFirstChunk{false};
+    std::atomic<uint64_t> attachLatencyUs{0};
+
+    void standbyLoop(StandbySlot* slot) {
+        HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        WaitForSingleObject(slot->goEvent, INFINITE);
+        if (!slot->shutdown.load()) {
+            // start() has fully configured the capture state before
+            // signaling, so this wakes directly into the hot loop
+            captureLoop();
+        }
+        if (SUCCEEDED(hr)) CoUninitialize();
+    }
+
+
     ThreadSafeAudioQueue audioQueue;
+    LockFreeChunkRing audioRing;
+    bool lockFreeMode = false;
+    std::shared_ptr<ChunkBufferPool> chunkPool;
     size_t chunkSize = 480;  // 10ms at 48kHz
     
     // Event-driven support
     HANDLE audioDataEvent = nullptr;
     HANDLE stopEvent = nullptr;
     bool eventDrivenMode = false;
-    
+
+    // Low-latency mode: negotiate the minimum engine period through
+    // IAudioClient3 instead of the ~10ms default
+    bool lowLatencyMode = false;
+    uint32_t negotiatedPeriodFrames = 0;  // 0 = default period in use
+
+    // Loopback activation mode: include the target process tree
+    // (default) or capture everything EXCEPT it
+    bool excludeProcessTree = false;
+
+    // Watchdog supervision (see superviseCapture/recoverCapture): detect
+    // stalled delivery, device invalidation and target-process exit, and
+    // reinitialize in-thread instead of a full stop()/start() round trip
+    bool watchdogEnabled = false;
+    uint32_t stallTimeoutMs = 2000;
+    uint32_t maxRestarts = 5;
+    DWORD capturePid = 0;
+    HANDLE targetProcessHandle = nullptr;   // SYNCHRONIZE; include mode only
+    std::atomic<size_t> restarts{0};
+    std::atomic<uint64_t> lastRecoveryUs{0};
+    std::atomic<bool> targetProcessExited{false};
+
+    // Self-profiling: a duplicated capture-thread handle keeps
+    // GetThreadTimes answerable after the thread exits, and memcpyBytes
+    // counts what the hot path actually moves (WASAPI packet -> chunk,
+    // resampler output, replay ring, shm mirror)
+    HANDLE captureThreadHandle = nullptr;
+    std::atomic<uint64_t> memcpyBytes{0};
+
     // Performance metrics
     std::atomic<size_t> totalFramesCaptured{0};
     std::atomic<size_t> totalSilentFrames{0};
@@ -228,86 +473,822 @@ private:
     std::atomic<size_t> eventSignals{0};
     std::atomic<size_t> timeouts{0};
     std::chrono::steady_clock::time_point startTime;
-    
-    void captureLoop() {
-        // Set thread priority for audio
-        DWORD taskIndex = 0;
-        HANDLE hTask = AvSetMmThreadCharacteristics(TEXT("Audio"), &taskIndex);
-        
-        if (hTask == NULL) {
-            std::cerr << "Warning: Could not set thread characteristics" << std::endl;
+    size_t lastDroppedChunks = 0;  // For pop_frames discontinuity detection
+
+    // Hot-path latency instrumentation (see LatencyHistogram): time from
+    // WASAPI event signal to chunk-in-queue, chunk age at pop time, and
+    // the packet sizes WASAPI hands us
+    LatencyHistogram eventToPushHist;   // microseconds
+    LatencyHistogram queueResidencyHist;  // microseconds
+    LatencyHistogram packetSizeHist;    // frames
+    std::chrono::steady_clock::time_point lastEventTime;
+
+    // Optional transform stage, configured before start() and applied in
+    // the capture loop while the chunk is still hot in cache
+    float transformGain = 1.0f;
+    bool transformMono = false;
+    uint32_t resampleRate = 0;  // 0 = passthrough (native 48kHz)
+    std::unique_ptr<PolyphaseResampler> resampler;
+    std::vector<float> resampleBuffer;  // Reused across chunks
+
+    // Shared-memory export (configured while not capturing, written
+    // from the capture thread only)
+    HANDLE shmMapping = nullptr;
+    ShmRingHeader* shmHeader = nullptr;
+    float* shmData = nullptr;
+
+    // Frame-sequence stamping (see pushChunk); capture thread only
+    uint64_t nextSequenceFrame = 0;
+
+    // Capture-thread level metering: block-window peak/sum-of-squares
+    // accumulators live on the capture thread; each finished window
+    // publishes to the atomics get_levels() reads, so meters cost one
+    // SIMD scan per chunk and zero queue traffic. metering_only mode
+    // discards chunks after metering - monitor without paying for data.
+    std::atomic<bool> meteringEnabled{false};
+    std::atomic<bool> meteringOnly{false};
+    uint32_t meterWindowMs = 100;
+    float meterAccPeak = 0.0f;    // Capture thread only
+    double meterAccSumSq = 0.0;   // Capture thread only
+    size_t meterAccSamples = 0;   // Capture thread only
+    std::atomic<float> meterPeak{0.0f};
+    std::atomic<float> meterRms{0.0f};
+    std::atomic<size_t> meterDiscardedChunks{0};
+
+    void meterChunk(const AudioChunk& chunk) {
+        size_t samples = chunk.frameCount * chunk.channels;
+        if (!chunk.silent && !chunk.gap) {
+            float peak = 0.0f;
+            double sumSq = 0.0;
+            PeakAndSumSquares(chunk.data.data(), samples, peak, sumSq);
+            if (peak > meterAccPeak) meterAccPeak = peak;
+            meterAccSumSq += sumSq;
         }
-        
-        HRESULT hr = audioClient->Start();
-        if (FAILED(hr)) {
-            std::cerr << "Failed to start audio client: 0x" << std::hex << hr << std::endl;
-            captureErrors++;
-            if (hTask) AvRevertMmThreadCharacteristics(hTask);
-            return;
+        // Silent chunks and gaps still advance the window with zeros
+        meterAccSamples += samples;
+
+        size_t windowSamples = static_cast<size_t>(effectiveSampleRate()) *
+                               outputChannels() * meterWindowMs / 1000;
+        if (windowSamples > 0 && meterAccSamples >= windowSamples) {
+            meterPeak.store(meterAccPeak, std::memory_order_relaxed);
+            meterRms.store(static_cast<float>(
+                std::sqrt(meterAccSumSq / meterAccSamples)),
+                std::memory_order_relaxed);
+            meterAccPeak = 0.0f;
+            meterAccSumSq = 0.0;
+            meterAccSamples = 0;
         }
-        
-        std::cout << "Capture thread started";
-        if (eventDrivenMode) {
-            std::cout << " (event-driven mode)";
+    }
+
+    // Always-on replay ring ("last N seconds"): every emitted chunk is
+    // memcpy'd into a preallocated circular sample buffer, so the steady
+    // state costs one copy - no allocations, no queue and no Python
+    // traffic. save_replay/get_replay snapshot the window on demand.
+    std::vector<float> replayBuffer;        // replayCapacityFrames * channels
+    size_t replayCapacityFrames = 0;
+    size_t replayWriteFrame = 0;            // next write position, in frames
+    uint64_t replayTotalFrames = 0;         // frames ever written
+    double replaySeconds = 0.0;
+    std::atomic<bool> replayOnly{false};
+    mutable std::mutex replayMutex;
+
+    void replayWrite(const AudioChunk& chunk) {
+        std::lock_guard<std::mutex> lock(replayMutex);
+        if (replayCapacityFrames == 0) return;
+
+        const size_t channels = chunk.channels;
+        size_t framesLeft = chunk.frameCount;
+        size_t srcFrame = 0;
+        while (framesLeft > 0) {
+            size_t run = (std::min)(framesLeft, replayCapacityFrames - replayWriteFrame);
+            float* dst = replayBuffer.data() + replayWriteFrame * channels;
+            if (chunk.gap) {
+                std::memset(dst, 0, run * channels * sizeof(float));
+            } else {
+                std::memcpy(dst, chunk.data.data() + srcFrame * channels,
+                            run * channels * sizeof(float));
+                memcpyBytes.fetch_add(run * channels * sizeof(float),
+                                      std::memory_order_relaxed);
+            }
+            replayWriteFrame = (replayWriteFrame + run) % replayCapacityFrames;
+            srcFrame += run;
+            framesLeft -= run;
+        }
+        replayTotalFrames += chunk.frameCount;
+    }
+
+    // Linearize the ring oldest-first into out. Returns the frame count;
+    // firstFrame receives the absolute index of the snapshot's first
+    // frame (same clock as chunk sequence numbers).
+    size_t snapshotReplay(std::vector<float>& out, uint64_t& firstFrame) const {
+        std::lock_guard<std::mutex> lock(replayMutex);
+        const size_t channels = outputChannels();
+        size_t frames = static_cast<size_t>(
+            (std::min)(replayTotalFrames, static_cast<uint64_t>(replayCapacityFrames)));
+        out.resize(frames * channels);
+        firstFrame = replayTotalFrames - frames;
+        if (frames == 0) return 0;
+
+        if (replayTotalFrames <= replayCapacityFrames) {
+            // Not wrapped yet: ring is already linear
+            std::memcpy(out.data(), replayBuffer.data(),
+                        frames * channels * sizeof(float));
         } else {
-            std::cout << " (polling mode)";
+            size_t tailFrames = replayCapacityFrames - replayWriteFrame;
+            std::memcpy(out.data(),
+                        replayBuffer.data() + replayWriteFrame * channels,
+                        tailFrames * channels * sizeof(float));
+            std::memcpy(out.data() + tailFrames * channels,
+                        replayBuffer.data(),
+                        replayWriteFrame * channels * sizeof(float));
         }
-        std::cout << ", chunk size: " << chunkSize << " frames" << std::endl;
-        
-        // Accumulator for partial chunks
-        AudioChunk currentChunk(chunkSize);
-        size_t currentOffset = 0;
-        
-        while (!shouldStop) {
-            bool dataAvailable = false;
-            
-            if (eventDrivenMode && audioDataEvent && stopEvent) {
-                // Wait for audio event or stop signal
-                HANDLE events[2] = { stopEvent, audioDataEvent };
-                DWORD waitResult = WaitForMultipleObjects(2, events, FALSE, 100);
-                
-                if (waitResult == WAIT_OBJECT_0) {
-                    // Stop event signaled
-                    break;
-                } else if (waitResult == WAIT_OBJECT_0 + 1) {
-                    // Audio data available
-                    dataAvailable = true;
-                    eventSignals++;
-                } else if (waitResult == WAIT_TIMEOUT) {
-                    timeouts++;
+        return frames;
+    }
+
+    // Silence suppression: silent chunks collapse into run-length gap
+    // records instead of materialized zero buffers
+    bool suppressSilence = false;
+    size_t pendingGapFrames = 0;
+    std::chrono::steady_clock::time_point gapStartTime;
+    std::atomic<size_t> suppressedChunks{0};
+
+    uint32_t outputChannels() const {
+        return transformMono ? 1 : 2;
+    }
+
+    uint32_t effectiveSampleRate() const {
+        return resampleRate ? resampleRate : 48000;
+    }
+
+    void applyTransform(AudioChunk& chunk) {
+        if (transformGain != 1.0f && !chunk.silent) {
+            ApplyGain(chunk.data.data(), chunk.frameCount * chunk.channels, transformGain);
+        }
+
+        if (transformMono && chunk.channels == 2) {
+            AudioChunk mono;
+            mono.data = chunkPool->acquire(chunk.frameCount);
+            mono.frameCount = chunk.frameCount;
+            mono.channels = 1;
+            mono.silent = chunk.silent;
+            mono.timestamp = chunk.timestamp;
+            mono.devicePosition = chunk.devicePosition;
+            mono.qpcTime = chunk.qpcTime;
+            DownmixStereoToMono(chunk.data.data(), mono.data.data(), chunk.frameCount);
+            chunkPool->release(std::move(chunk.data));
+            chunk = std::move(mono);
+        }
+
+        if (resampler) {
+            resampleBuffer.clear();
+            resampler->process(chunk.data.data(), chunk.frameCount, resampleBuffer);
+
+            AudioChunk out;
+            out.data = chunkPool->acquire(resampleBuffer.size());
+            std::memcpy(out.data.data(), resampleBuffer.data(),
+                        resampleBuffer.size() * sizeof(float));
+            memcpyBytes.fetch_add(resampleBuffer.size() * sizeof(float),
+                                  std::memory_order_relaxed);
+            out.frameCount = resampleBuffer.size() / chunk.channels;
+            out.channels = chunk.channels;
+            out.silent = chunk.silent;
+            out.timestamp = chunk.timestamp;
+            out.devicePosition = chunk.devicePosition;
+            out.qpcTime = chunk.qpcTime;
+            chunkPool->release(std::move(chunk.data));
+            chunk = std::move(out);
+        }
+    }
+
+    // Native recording sink: a writer thread consumes the queue directly
+    // in C++, so long recordings never touch Python
+    std::thread writerThread;
+    std::atomic<bool> recording{false};
+    std::atomic<bool> stopRecordingFlag{false};
+    std::string recordingPath;
+    bool recordInt16 = true;
+    std::atomic<size_t> framesWritten{0};
+    std::atomic<size_t> writeErrors{0};
+
+    // Compressed sink (Media Foundation IMFSinkWriter). The encoder runs
+    // on the writer thread and consumes chunks straight from the queue,
+    // same as the WAV path - no Python, no intermediate WAV file.
+    enum RecordCodec { kCodecWav = 0, kCodecFlac, kCodecAac };
+    int recordCodec = kCodecWav;
+    uint32_t encoderBitrate = 192000;   // bits/s; lossy (AAC) sink only
+    std::atomic<uint64_t> encoderCpuUs{0};
+
+    void writerLoop() {
+        FILE* file = nullptr;
+        if (fopen_s(&file, recordingPath.c_str(), "wb") != 0 || !file) {
+            std::cerr << "Failed to open recording file: " << recordingPath << std::endl;
+            writeErrors++;
+            recording = false;
+            return;
+        }
+
+        // Large stdio buffer so disk writes happen in ~1MB blocks instead
+        // of one syscall per 10ms chunk
+        setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+        uint16_t formatTag = recordInt16 ? WAVE_FORMAT_PCM : WAVE_FORMAT_IEEE_FLOAT;
+        uint16_t bits = recordInt16 ? 16 : 32;
+        uint16_t fileChannels = static_cast<uint16_t>(outputChannels());
+        uint32_t fileRate = effectiveSampleRate();
+        WriteWavHeader(file, formatTag, fileChannels, fileRate, bits, 0);
+
+        std::vector<int16_t> convBuffer;
+        uint32_t dataBytes = 0;
+
+        std::vector<char> zeroBuffer;
+
+        auto writeChunks = [&](std::vector<AudioChunk>& chunks) {
+            for (auto& chunk : chunks) {
+                size_t samples = chunk.frameCount * chunk.channels;
+                size_t written = 0;
+
+                if (chunk.gap) {
+                    // Suppressed silence: write zeros so file timing stays
+                    // continuous
+                    size_t sampleBytes = recordInt16 ? sizeof(int16_t) : sizeof(float);
+                    size_t bytes = samples * sampleBytes;
+                    if (zeroBuffer.size() < (std::min)(bytes, size_t(1) << 16)) {
+                        zeroBuffer.assign((std::min)(bytes, size_t(1) << 16), 0);
+                    }
+                    size_t remaining = bytes;
+                    size_t ok = 0;
+                    while (remaining > 0) {
+                        size_t step = (std::min)(remaining, zeroBuffer.size());
+                        ok += fwrite(zeroBuffer.data(), 1, step, file);
+                        remaining -= step;
+                    }
+                    if (ok != bytes) writeErrors++;
+                    dataBytes += static_cast<uint32_t>(ok);
+                    framesWritten += chunk.frameCount;
+                    recycleChunk(chunk);
                     continue;
                 }
-            } else {
-                // Polling mode - always check for data
-                dataAvailable = true;
-            }
-            
-            if (!dataAvailable) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                continue;
+
+                if (recordInt16) {
+                    if (convBuffer.size() < samples) convBuffer.resize(samples);
+                    ConvertFloat32ToInt16(chunk.data.data(), convBuffer.data(), samples);
+                    written = fwrite(convBuffer.data(), sizeof(int16_t), samples, file);
+                    dataBytes += static_cast<uint32_t>(written * sizeof(int16_t));
+                } else {
+                    written = fwrite(chunk.data.data(), sizeof(float), samples, file);
+                    dataBytes += static_cast<uint32_t>(written * sizeof(float));
+                }
+
+                if (written != samples) {
+                    writeErrors++;
+                }
+                framesWritten += chunk.frameCount;
+                recycleChunk(chunk);
             }
-            
-            UINT32 packetSize = 0;
-            hr = captureClient->GetNextPacketSize(&packetSize);
-            
-            if (FAILED(hr)) {
-                captureErrors++;
-                if (!eventDrivenMode) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        };
+
+        while (!stopRecordingFlag) {
+            auto chunks = popBatchInternal(64, 100);
+            writeChunks(chunks);
+        }
+
+        // Final drain so the tail of the recording is not lost
+        auto chunks = popBatchInternal(1024, 0);
+        writeChunks(chunks);
+
+        // Rewrite the header with the real data size
+        fflush(file);
+        if (fseek(file, 0, SEEK_SET) == 0) {
+            WriteWavHeader(file, formatTag, fileChannels, fileRate, bits, dataBytes);
+        } else {
+            writeErrors++;
+        }
+        fclose(file);
+    }
+
+    // Compressed-sink writer loop. All Media Foundation state lives on
+    // this thread; the only traffic with the rest of the instance is the
+    // chunk queue. FLAC keeps every bit at a fraction of the WAV size,
+    // AAC encodes down to encoderBitrate.
+    void encoderLoop() {
+        HRESULT hr = MFStartup(MF_VERSION, MFSTARTUP_LITE);
+        if (FAILED(hr)) {
+            std::cerr << "MFStartup failed: 0x" << std::hex << hr << std::endl;
+            writeErrors++;
+            recording = false;
+            return;
+        }
+
+        const uint32_t rate = effectiveSampleRate();
+        const uint32_t chans = static_cast<uint32_t>(outputChannels());
+        const bool flac = (recordCodec == kCodecFlac);
+
+        int wideLen = MultiByteToWideChar(CP_UTF8, 0, recordingPath.c_str(), -1, nullptr, 0);
+        std::wstring widePath(static_cast<size_t>(wideLen), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, recordingPath.c_str(), -1, &widePath[0], wideLen);
+
+        ComPtr<IMFSinkWriter> writer;
+        ComPtr<IMFMediaType> outType;
+        ComPtr<IMFMediaType> inType;
+        DWORD streamIndex = 0;
+
+        // The container is picked from the file extension (.flac / .m4a)
+        hr = MFCreateSinkWriterFromURL(widePath.c_str(), nullptr, nullptr, &writer);
+
+        if (SUCCEEDED(hr)) hr = MFCreateMediaType(&outType);
+        if (SUCCEEDED(hr)) hr = outType->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio);
+        if (SUCCEEDED(hr)) hr = outType->SetGUID(MF_MT_SUBTYPE,
+                                                 flac ? MFAudioFormat_FLAC : MFAudioFormat_AAC);
+        if (SUCCEEDED(hr)) hr = outType->SetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, rate);
+        if (SUCCEEDED(hr)) hr = outType->SetUINT32(MF_MT_AUDIO_NUM_CHANNELS, chans);
+        if (SUCCEEDED(hr)) hr = outType->SetUINT32(MF_MT_AUDIO_BITS_PER_SAMPLE, 16);
+        if (SUCCEEDED(hr) && !flac) {
+            hr = outType->SetUINT32(MF_MT_AUDIO_AVG_BYTES_PER_SECOND, encoderBitrate / 8);
+        }
+        if (SUCCEEDED(hr)) hr = writer->AddStream(outType.Get(), &streamIndex);
+
+        // Input side: AAC takes float32 straight from the capture format;
+        // the FLAC encoder wants PCM16, converted with the same SSE2
+        // kernel the WAV sink uses
+        const uint32_t inBits = flac ? 16 : 32;
+        if (SUCCEEDED(hr)) hr = MFCreateMediaType(&inType);
+        if (SUCCEEDED(hr)) hr = inType->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio);
+        if (SUCCEEDED(hr)) hr = inType->SetGUID(MF_MT_SUBTYPE,
+                                                flac ? MFAudioFormat_PCM : MFAudioFormat_Float);
+        if (SUCCEEDED(hr)) hr = inType->SetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, rate);
+        if (SUCCEEDED(hr)) hr = inType->SetUINT32(MF_MT_AUDIO_NUM_CHANNELS, chans);
+        if (SUCCEEDED(hr)) hr = inType->SetUINT32(MF_MT_AUDIO_BITS_PER_SAMPLE, inBits);
+        if (SUCCEEDED(hr)) hr = inType->SetUINT32(MF_MT_AUDIO_BLOCK_ALIGNMENT, chans * inBits / 8);
+        if (SUCCEEDED(hr)) hr = inType->SetUINT32(MF_MT_AUDIO_AVG_BYTES_PER_SECOND,
+                                                  rate * chans * inBits / 8);
+        if (SUCCEEDED(hr)) hr = inType->SetUINT32(MF_MT_ALL_SAMPLES_INDEPENDENT, TRUE);
+        if (SUCCEEDED(hr)) hr = writer->SetInputMediaType(streamIndex, inType.Get(), nullptr);
+
+        if (SUCCEEDED(hr)) hr = writer->BeginWriting();
+
+        if (FAILED(hr)) {
+            std::cerr << "Failed to initialize " << (flac ? "FLAC" : "AAC")
+                      << " sink writer: 0x" << std::hex << hr << std::endl;
+            writeErrors++;
+            recording = false;
+            MFShutdown();
+            return;
+        }
+
+        FILETIME createFt, exitFt, kernelStart, userStart;
+        GetThreadTimes(GetCurrentThread(), &createFt, &exitFt, &kernelStart, &userStart);
+
+        std::vector<int16_t> convBuffer;
+        uint64_t sampleTime100ns = 0;   // running presentation time
+
+        auto writeChunks = [&](std::vector<AudioChunk>& chunks) {
+            for (auto& chunk : chunks) {
+                const size_t samples = chunk.frameCount * chunk.channels;
+                const size_t sampleBytes = flac ? sizeof(int16_t) : sizeof(float);
+                const DWORD bytes = static_cast<DWORD>(samples * sampleBytes);
+                const uint64_t duration = chunk.frameCount * 10000000ull / rate;
+
+                ComPtr<IMFMediaBuffer> buffer;
+                ComPtr<IMFSample> sample;
+                BYTE* dst = nullptr;
+                HRESULT whr = MFCreateMemoryBuffer(bytes, &buffer);
+                if (SUCCEEDED(whr)) whr = buffer->Lock(&dst, nullptr, nullptr);
+                if (SUCCEEDED(whr)) {
+                    if (chunk.gap) {
+                        // Suppressed silence: feed zeros so the encoded
+                        // timeline stays continuous
+                        std::memset(dst, 0, bytes);
+                    } else if (flac) {
+                        if (convBuffer.size() < samples) convBuffer.resize(samples);
+                        ConvertFloat32ToInt16(chunk.data.data(), convBuffer.data(), samples);
+                        std::memcpy(dst, convBuffer.data(), bytes);
+                    } else {
+                        std::memcpy(dst, chunk.data.data(), bytes);
+                    }
+                    buffer->Unlock();
+                    whr = buffer->SetCurrentLength(bytes);
                 }
-                continue;
+                if (SUCCEEDED(whr)) whr = MFCreateSample(&sample);
+                if (SUCCEEDED(whr)) whr = sample->AddBuffer(buffer.Get());
+                if (SUCCEEDED(whr)) whr = sample->SetSampleTime(
+                    static_cast<LONGLONG>(sampleTime100ns));
+                if (SUCCEEDED(whr)) whr = sample->SetSampleDuration(
+                    static_cast<LONGLONG>(duration));
+                if (SUCCEEDED(whr)) whr = writer->WriteSample(streamIndex, sample.Get());
+
+                if (FAILED(whr)) {
+                    writeErrors++;
+                } else {
+                    framesWritten += chunk.frameCount;
+                }
+                sampleTime100ns += duration;
+                recycleChunk(chunk);
             }
-            
-            while (packetSize != 0 && !shouldStop) {
+        };
+
+        while (!stopRecordingFlag) {
+            auto chunks = popBatchInternal(64, 100);
+            writeChunks(chunks);
+        }
+
+        // Final drain, then flush the encoder's lookahead and write the
+        // container trailer
+        auto chunks = popBatchInternal(1024, 0);
+        writeChunks(chunks);
+
+        if (FAILED(writer->Finalize())) {
+            writeErrors++;
+        }
+
+        // Encoder cost = this thread's CPU time over the whole recording
+        // (the memcpy/convert overhead is the same as the WAV sink's)
+        FILETIME kernelEnd, userEnd;
+        GetThreadTimes(GetCurrentThread(), &createFt, &exitFt, &kernelEnd, &userEnd);
+        auto deltaUs = [](const FILETIME& from, const FILETIME& to) {
+            ULARGE_INTEGER a, b;
+            a.LowPart = from.dwLowDateTime; a.HighPart = from.dwHighDateTime;
+            b.LowPart = to.dwLowDateTime;   b.HighPart = to.dwHighDateTime;
+            return (b.QuadPart - a.QuadPart) / 10;
+        };
+        encoderCpuUs = deltaUs(kernelStart, kernelEnd) + deltaUs(userStart, userEnd);
+
+        writer.Reset();
+        MFShutdown();
+    }
+
+    // Build a chunk whose buffer comes from the pool. In steady state
+    // this performs no heap allocation.
+    AudioChunk makeChunk(size_t frames) {
+        AudioChunk chunk;
+        chunk.data = chunkPool->acquire(frames * 2);
+        chunk.frameCount = frames;
+        chunk.timestamp = std::chrono::steady_clock::now();
+        return chunk;
+    }
+
+    // Hand a chunk's buffer back to the pool once its samples have been
+    // copied out to Python.
+    void recycleChunk(AudioChunk& chunk) {
+        chunkPool->release(std::move(chunk.data));
+    }
+
+    // Emit a pending silence gap as a single lightweight record (start
+    // timestamp + frame count, no buffer). Capture thread only.
+    void flushGap() {
+        if (pendingGapFrames == 0) return;
+
+        AudioChunk gapRecord;
+        gapRecord.frameCount = pendingGapFrames;
+        gapRecord.channels = outputChannels();
+        gapRecord.silent = true;
+        gapRecord.gap = true;
+        gapRecord.timestamp = gapStartTime;
+        pendingGapFrames = 0;
+        shmWrite(gapRecord);
+        pushChunk(std::move(gapRecord));
+    }
+
+    // Mirror a chunk into the shared-memory ring (capture thread only).
+    // Two memcpys at most (wrap), then a release-store of the frame
+    // counter to publish.
+    void shmWrite(const AudioChunk& chunk) {
+        if (!shmHeader) return;
+
+        uint64_t w = shmHeader->totalFramesWritten.load(std::memory_order_relaxed);
+        uint64_t cap = shmHeader->capacityFrames;
+        size_t stride = shmHeader->channels;
+        size_t frames = chunk.frameCount;
+
+        uint64_t pos = w % cap;
+        size_t first = static_cast<size_t>((std::min)(
+            static_cast<uint64_t>(frames), cap - pos));
+
+        if (chunk.gap) {
+            std::memset(shmData + pos * stride, 0, first * stride * sizeof(float));
+            if (frames > first) {
+                std::memset(shmData, 0, (frames - first) * stride * sizeof(float));
+            }
+        } else {
+            std::memcpy(shmData + pos * stride, chunk.data.data(),
+                        first * stride * sizeof(float));
+            if (frames > first) {
+                std::memcpy(shmData, chunk.data.data() + first * stride,
+                            (frames - first) * stride * sizeof(float));
+            }
+            memcpyBytes.fetch_add(frames * stride * sizeof(float),
+                                  std::memory_order_relaxed);
+        }
+
+        shmHeader->totalFramesWritten.store(w + frames, std::memory_order_release);
+    }
+
+    // Push a finished chunk, or - with suppression enabled - fold silent
+    // chunks into a gap record. Gaps are flushed when audio resumes and
+    // at one-second boundaries so consumers see timing promptly.
+    void emitChunk(AudioChunk&& chunk) {
+        if (meteringEnabled.load(std::memory_order_relaxed)) {
+            meterChunk(chunk);
+            if (meteringOnly.load(std::memory_order_relaxed)) {
+                meterDiscardedChunks.fetch_add(1, std::memory_order_relaxed);
+                recycleChunk(chunk);
+                return;
+            }
+        }
+        if (replayCapacityFrames > 0) {
+            // Replay sees the stream before silence suppression, so the
+            // window is always sample-continuous
+            replayWrite(chunk);
+            if (replayOnly.load(std::memory_order_relaxed)) {
+                recycleChunk(chunk);
+                return;
+            }
+        }
+        if (suppressSilence) {
+            if (chunk.silent) {
+                if (pendingGapFrames == 0) {
+                    gapStartTime = chunk.timestamp;
+                }
+                pendingGapFrames += chunk.frameCount;
+                suppressedChunks.fetch_add(1, std::memory_order_relaxed);
+                recycleChunk(chunk);
+                if (pendingGapFrames >= effectiveSampleRate()) {
+                    flushGap();
+                }
+                return;
+            }
+            flushGap();
+        }
+        shmWrite(chunk);
+        if (awaitingFirstChunk.exchange(false)) {
+            attachLatencyUs.store(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - startCallTime).count());
+        }
+        pushChunk(std::move(chunk));
+    }
+
+    // Route a finished chunk to the configured queue implementation.
+    // In lock-free mode this never takes a lock and never blocks the
+    // capture thread, even if Python is stalled in a GC pause.
+    // Every chunk (gap records included) is stamped with the absolute
+    // frame index of its first frame, so a drop anywhere leaves an
+    // exactly sized, detectable hole in the sequence.
+    bool pushChunk(AudioChunk&& chunk) {
+        chunk.sequence = nextSequenceFrame;
+        nextSequenceFrame += chunk.frameCount;
+        if (lockFreeMode) {
+            return audioRing.push(std::move(chunk));
+        }
+        return audioQueue.push(std::move(chunk));
+    }
+
+    std::vector<AudioChunk> popBatchInternal(size_t maxChunks, int timeoutMs) {
+        auto batch = lockFreeMode ? audioRing.popBatch(maxChunks, timeoutMs)
+                                  : audioQueue.popBatch(maxChunks, timeoutMs);
+
+        auto now = std::chrono::steady_clock::now();
+        for (const auto& chunk : batch) {
+            queueResidencyHist.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    now - chunk.timestamp).count()));
+        }
+        return batch;
+    }
+
+    // Cumulative kernel+user CPU of the capture thread in microseconds.
+    // Valid while the duplicated handle is open - including after the
+    // thread has exited, so post-stop metrics still show what the last
+    // run cost.
+    uint64_t captureCpuUs() const {
+        if (!captureThreadHandle) return 0;
+        FILETIME createTime, exitTime, kernelTime, userTime;
+        if (!GetThreadTimes(captureThreadHandle, &createTime, &exitTime,
+                            &kernelTime, &userTime)) {
+            return 0;
+        }
+        auto toUs = [](const FILETIME& ft) {
+            ULARGE_INTEGER v;
+            v.LowPart = ft.dwLowDateTime;
+            v.HighPart = ft.dwHighDateTime;
+            return v.QuadPart / 10;  // 100ns -> us
+        };
+        return toUs(kernelTime) + toUs(userTime);
+    }
+
+    // In-thread recovery: reactivate and reinitialize the loopback client
+    // on the capture thread itself. COM, MMCSS and the event handles are
+    // already in place and the queue stays open, so consumers see a gap
+    // record instead of a torn-down session - the blackout is activation
+    // plus one engine period, not a full stop()/start() round trip.
+    // Consumes one unit of the restart budget whether or not it succeeds.
+    bool recoverCapture() {
+        auto recoveryStart = std::chrono::steady_clock::now();
+        restarts.fetch_add(1, std::memory_order_relaxed);
+
+        if (audioClient) audioClient->Stop();
+        captureClient.Reset();
+        audioClient.Reset();
+
+        ComPtr<IAudioClient> newClient;
+        // Bound reactivation by the stall timeout: a hung audio service
+        // must cost one failed recovery attempt, not a wedged capture
+        // thread that stop() can never join
+        if (!ActivateProcessLoopbackClient(capturePid, newClient, excludeProcessTree,
+                                           static_cast<int>(stallTimeoutMs))) {
+            return false;
+        }
+        audioClient = newClient;
+
+        WAVEFORMATEX format = ProcessLoopbackFormat();
+        DWORD streamFlags = AUDCLNT_STREAMFLAGS_LOOPBACK;
+        if (eventDrivenMode) streamFlags |= AUDCLNT_STREAMFLAGS_EVENTCALLBACK;
+        HRESULT hr = audioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, streamFlags,
+                                             0, 0, &format, nullptr);
+        if (FAILED(hr)) {
+            std::cerr << "Watchdog: reinitialize failed: 0x" << std::hex << hr << std::endl;
+            return false;
+        }
+
+        if (eventDrivenMode) {
+            hr = audioClient->SetEventHandle(audioDataEvent);
+            if (FAILED(hr)) return false;
+        }
+
+        hr = audioClient->GetService(__uuidof(IAudioCaptureClient),
+                                     reinterpret_cast<void**>(captureClient.GetAddressOf()));
+        if (FAILED(hr)) return false;
+
+        hr = audioClient->Start();
+        if (FAILED(hr)) return false;
+
+        auto recoveryUs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - recoveryStart).count());
+        lastRecoveryUs.store(recoveryUs, std::memory_order_relaxed);
+
+        // Mark the hole: a gap record sized to the blackout keeps the
+        // sequence clock honest for consumers
+        AudioChunk gapRecord;
+        gapRecord.frameCount = static_cast<size_t>(
+            recoveryUs * effectiveSampleRate() / 1000000);
+        gapRecord.channels = outputChannels();
+        gapRecord.silent = true;
+        gapRecord.gap = true;
+        gapRecord.timestamp = std::chrono::steady_clock::now();
+        if (gapRecord.frameCount > 0) {
+            shmWrite(gapRecord);
+            pushChunk(std::move(gapRecord));
+        }
+
+        std::cout << "Capture recovered in " << std::dec << (recoveryUs / 1000)
+                  << "ms (restart " << restarts.load() << ")" << std::endl;
+        return true;
+    }
+
+    // Watchdog checks run off the wait path (event timeouts / polling
+    // idles). Returns false when the loop should end: target process
+    // gone, or stalled with the restart budget exhausted.
+    bool superviseCapture(std::chrono::steady_clock::time_point& lastFrameTime) {
+        if (!watchdogEnabled) return true;
+
+        if (targetProcessHandle &&
+            WaitForSingleObject(targetProcessHandle, 0) == WAIT_OBJECT_0) {
+            std::cout << "Target process exited, ending capture" << std::endl;
+            targetProcessExited = true;
+            return false;
+        }
+
+        auto stalledMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - lastFrameTime).count();
+        if (stalledMs < static_cast<long long>(stallTimeoutMs)) return true;
+
+        if (restarts.load() >= maxRestarts) {
+            std::cerr << "Watchdog: stalled " << std::dec << stalledMs
+                      << "ms with restart budget exhausted, ending capture" << std::endl;
+            return false;
+        }
+
+        std::cerr << "Watchdog: no frames for " << std::dec << stalledMs
+                  << "ms, reinitializing" << std::endl;
+        if (!recoverCapture()) {
+            captureErrors++;
+        }
+        lastFrameTime = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    void captureLoop() {
+        // Set thread priority for audio
+        DWORD taskIndex = 0;
+        HANDLE hTask = AvSetMmThreadCharacteristics(TEXT("Audio"), &taskIndex);
+        
+        if (hTask == NULL) {
+            std::cerr << "Warning: Could not set thread characteristics" << std::endl;
+        }
+        
+        HRESULT hr = audioClient->Start();
+        if (FAILED(hr)) {
+            std::cerr << "Failed to start audio client: 0x" << std::hex << hr << std::endl;
+            captureErrors++;
+            if (hTask) AvRevertMmThreadCharacteristics(hTask);
+            return;
+        }
+        
+        std::cout << "Capture thread started";
+        if (eventDrivenMode) {
+            std::cout << " (event-driven mode)";
+        } else {
+            std::cout << " (polling mode)";
+        }
+        std::cout << ", chunk size: " << chunkSize << " frames" << std::endl;
+        
+        // Accumulator for partial chunks
+        AudioChunk currentChunk = makeChunk(chunkSize);
+        size_t currentOffset = 0;
+
+        auto lastFrameTime = std::chrono::steady_clock::now();
+        bool endedBySupervision = false;
+
+        while (!shouldStop) {
+            bool dataAvailable = false;
+
+            if (eventDrivenMode && audioDataEvent && stopEvent) {
+                // Wait for audio event, stop signal or (with the watchdog
+                // on) the target process exiting
+                HANDLE events[3] = { stopEvent, audioDataEvent, targetProcessHandle };
+                DWORD eventCount = (watchdogEnabled && targetProcessHandle) ? 3 : 2;
+                DWORD waitResult = WaitForMultipleObjects(eventCount, events, FALSE, 100);
+
+                if (waitResult == WAIT_OBJECT_0) {
+                    // Stop event signaled
+                    break;
+                } else if (waitResult == WAIT_OBJECT_0 + 1) {
+                    // Audio data available
+                    dataAvailable = true;
+                    eventSignals++;
+                    lastEventTime = std::chrono::steady_clock::now();
+                } else if (waitResult == WAIT_OBJECT_0 + 2) {
+                    // Target process exited - nothing left to capture
+                    std::cout << "Target process exited, ending capture" << std::endl;
+                    targetProcessExited = true;
+                    endedBySupervision = true;
+                    break;
+                } else if (waitResult == WAIT_TIMEOUT) {
+                    timeouts++;
+                    if (!superviseCapture(lastFrameTime)) {
+                        endedBySupervision = true;
+                        break;
+                    }
+                    continue;
+                }
+            } else {
+                // Polling mode - always check for data
+                dataAvailable = true;
+                lastEventTime = std::chrono::steady_clock::now();
+            }
+            
+            if (!dataAvailable) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            
+            UINT32 packetSize = 0;
+            hr = captureClient->GetNextPacketSize(&packetSize);
+
+            if (FAILED(hr)) {
+                captureErrors++;
+                // A device format change or removal invalidates the
+                // client for good - reinitialize instead of spinning on
+                // the dead interface
+                if (watchdogEnabled && hr == AUDCLNT_E_DEVICE_INVALIDATED) {
+                    if (restarts.load() >= maxRestarts || !recoverCapture()) {
+                        std::cerr << "Watchdog: device invalidated, recovery "
+                                  << "unavailable - ending capture" << std::endl;
+                        endedBySupervision = true;
+                        break;
+                    }
+                    lastFrameTime = std::chrono::steady_clock::now();
+                    continue;
+                }
+                if (!eventDrivenMode) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                continue;
+            }
+            
+            while (packetSize != 0 && !shouldStop) {
                 BYTE* pData = nullptr;
                 UINT32 framesAvailable = 0;
                 DWORD flags = 0;
-                
-                hr = captureClient->GetBuffer(&pData, &framesAvailable, &flags, nullptr, nullptr);
-                
+                UINT64 devicePosition = 0;
+                UINT64 qpcPosition = 0;  // 100ns units
+
+                hr = captureClient->GetBuffer(&pData, &framesAvailable, &flags,
+                                              &devicePosition, &qpcPosition);
+
                 if (SUCCEEDED(hr)) {
                     bool isSilent = (flags & AUDCLNT_BUFFERFLAGS_SILENT) != 0;
-                    
+
+                    packetSizeHist.record(framesAvailable);
                     if (isSilent) {
                         totalSilentFrames += framesAvailable;
                     }
@@ -319,7 +1300,17 @@ private:
                     
                     while (framesToProcess > 0) {
                         size_t framesToCopy = (framesToProcess < (chunkSize - currentOffset)) ? framesToProcess : (chunkSize - currentOffset);
-                        
+
+                        if (currentOffset == 0) {
+                            // Stamp the chunk with the engine position and
+                            // QPC of its first frame - adjusted for packets
+                            // split across chunk boundaries - so consumers
+                            // can align streams to sub-millisecond accuracy
+                            currentChunk.devicePosition = devicePosition + sourceOffset;
+                            currentChunk.qpcTime = qpcPosition +
+                                sourceOffset * 10000000ull / 48000;
+                        }
+
                         if (!isSilent && floatData) {
                             // Copy actual audio data
                             std::memcpy(
@@ -327,6 +1318,8 @@ private:
                                 floatData + sourceOffset * 2,
                                 framesToCopy * 2 * sizeof(float)
                             );
+                            memcpyBytes.fetch_add(framesToCopy * 2 * sizeof(float),
+                                                  std::memory_order_relaxed);
                         } else {
                             // Fill with silence
                             std::memset(
@@ -343,16 +1336,27 @@ private:
                         // If chunk is full, push to queue
                         if (currentOffset >= chunkSize) {
                             currentChunk.silent = isSilent;
-                            audioQueue.push(std::move(currentChunk));
+                            applyTransform(currentChunk);
+                            if (currentChunk.frameCount > 0) {
+                                emitChunk(std::move(currentChunk));
+                                eventToPushHist.record(static_cast<uint64_t>(
+                                    std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now() - lastEventTime)
+                                        .count()));
+                            } else {
+                                // Resampler still priming - recycle
+                                recycleChunk(currentChunk);
+                            }
                             
                             // Prepare new chunk
-                            currentChunk = AudioChunk(chunkSize);
+                            currentChunk = makeChunk(chunkSize);
                             currentOffset = 0;
                         }
                     }
                     
                     totalFramesCaptured += framesAvailable;
-                    
+                    lastFrameTime = std::chrono::steady_clock::now();
+
                     hr = captureClient->ReleaseBuffer(framesAvailable);
                     if (FAILED(hr)) {
                         captureErrors++;
@@ -370,31 +1374,83 @@ private:
             
             // Only sleep in polling mode
             if (!eventDrivenMode) {
+                if (!superviseCapture(lastFrameTime)) {
+                    endedBySupervision = true;
+                    break;
+                }
                 std::this_thread::sleep_for(std::chrono::milliseconds(1));
             }
         }
-        
+
         // Push any remaining partial chunk
         if (currentOffset > 0) {
             currentChunk.frameCount = currentOffset;
             currentChunk.data.resize(currentOffset * 2);
-            audioQueue.push(std::move(currentChunk));
+            applyTransform(currentChunk);
+            if (currentChunk.frameCount > 0) {
+                emitChunk(std::move(currentChunk));
+            }
         }
-        
+        flushGap();
+
         audioClient->Stop();
-        
+
         if (hTask) {
             AvRevertMmThreadCharacteristics(hTask);
         }
-        
+
+        if (endedBySupervision) {
+            // Spontaneous end (target exited / recovery exhausted), not a
+            // stop() call: close the queues so blocked consumers wake, and
+            // make isCapturing() reflect reality
+            capturing = false;
+            audioQueue.close();
+            audioRing.close();
+        }
+
         std::cout << "Capture thread stopped" << std::endl;
     }
     
 public:
-    QueueBasedProcessCapture(size_t queueSize = 1000) : audioQueue(queueSize) {}
-    
+    QueueBasedProcessCapture(size_t queueSize = 1000, bool lockFree = false,
+                             size_t poolSize = 64)
+        : audioQueue(queueSize), audioRing(queueSize), lockFreeMode(lockFree),
+          chunkPool(std::make_shared<ChunkBufferPool>(poolSize, 480 * 2)) {
+        std::lock_guard<std::mutex> lock(g_captureRegistryMutex);
+        g_captureRegistry.push_back(this);
+    }
+
     ~QueueBasedProcessCapture() {
+        {
+            // Leave the registry before any member starts dying, so a
+            // concurrent get_resource_summary() never sees a half-torn
+            // instance
+            std::lock_guard<std::mutex> lock(g_captureRegistryMutex);
+            g_captureRegistry.erase(
+                std::remove(g_captureRegistry.begin(), g_captureRegistry.end(), this),
+                g_captureRegistry.end());
+        }
         stop();
+        stopShmExport();
+
+        // Wake and reap unbound standby slots, then close event handles
+        // (retired slots' threads were joined by stop() via captureThread)
+        {
+            std::lock_guard<std::mutex> lock(standbyMutex);
+            for (auto& slot : standbySlots) {
+                slot->shutdown = true;
+                SetEvent(slot->goEvent);
+            }
+            for (auto& slot : standbySlots) {
+                if (slot->thread.joinable()) slot->thread.join();
+                CloseHandle(slot->goEvent);
+            }
+            standbySlots.clear();
+            for (auto& slot : retiredSlots) {
+                CloseHandle(slot->goEvent);
+            }
+            retiredSlots.clear();
+        }
         if (waveFormat) {
             CoTaskMemFree(waveFormat);
         }
@@ -406,23 +1462,39 @@ public:
             CloseHandle(stopEvent);
             stopEvent = nullptr;
         }
+        if (captureThreadHandle) {
+            CloseHandle(captureThreadHandle);
+            captureThreadHandle = nullptr;
+        }
     }
     
-    bool start(DWORD processId) {
+    bool start(DWORD processId, int timeoutMs = 10000) {
         if (capturing.load()) {
             std::cerr << "Already capturing" << std::endl;
             return false;
         }
-        
+
+        // A direct blocking start must not inherit a stale cancel; the
+        // async path resets the flag itself before spawning its worker
+        if (startState.load() != kStartActivating) {
+            cancelRequested = false;
+        }
+
+        startCallTime = std::chrono::steady_clock::now();
+        capturePid = processId;
+
         HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
         bool needsUninit = SUCCEEDED(hr);
         
-        std::cout << "Starting capture for PID: " << processId << std::endl;
-        
+        std::cout << "Starting capture " << (excludeProcessTree ? "excluding" : "for")
+                  << " PID: " << processId << std::endl;
+
         // Create activation parameters
         AUDIOCLIENT_ACTIVATION_PARAMS activationParams = {};
         activationParams.ActivationType = AUDIOCLIENT_ACTIVATION_TYPE_PROCESS_LOOPBACK;
-        activationParams.ProcessLoopbackParams.ProcessLoopbackMode = PROCESS_LOOPBACK_MODE_INCLUDE_TARGET_PROCESS_TREE;
+        activationParams.ProcessLoopbackParams.ProcessLoopbackMode = excludeProcessTree
+            ? PROCESS_LOOPBACK_MODE_EXCLUDE_TARGET_PROCESS_TREE
+            : PROCESS_LOOPBACK_MODE_INCLUDE_TARGET_PROCESS_TREE;
         activationParams.ProcessLoopbackParams.TargetProcessId = processId;
         
         PROPVARIANT activateParams = {};
@@ -450,9 +1522,27 @@ public:
             return false;
         }
         
-        // Wait for completion
-        completionHandler->Wait();
-        
+        // Wait for completion - bounded and cancellable, so a slow audio
+        // service or a bad PID can no longer hang the caller forever
+        auto activationDeadline = std::chrono::steady_clock::now() +
+                                  std::chrono::milliseconds(timeoutMs);
+        bool activationDone = false;
+        while (!activationDone) {
+            activationDone = completionHandler->WaitFor(50);
+            if (activationDone) break;
+            if (cancelRequested.load()) {
+                std::cerr << "Capture start cancelled" << std::endl;
+                if (needsUninit) CoUninitialize();
+                return false;
+            }
+            if (std::chrono::steady_clock::now() >= activationDeadline) {
+                std::cerr << "Audio activation timed out after " << std::dec
+                          << timeoutMs << "ms" << std::endl;
+                if (needsUninit) CoUninitialize();
+                return false;
+            }
+        }
+
         if (FAILED(completionHandler->activateResult)) {
             std::cerr << "Audio activation failed: 0x" << std::hex << completionHandler->activateResult << std::endl;
             if (needsUninit) CoUninitialize();
@@ -474,16 +1564,61 @@ public:
         // Try event-driven mode first
         DWORD streamFlags = AUDCLNT_STREAMFLAGS_LOOPBACK | AUDCLNT_STREAMFLAGS_EVENTCALLBACK;
         bool tryEventDriven = true;
-        
+        bool initialized = false;
+        negotiatedPeriodFrames = 0;
+
+        // Low-latency path: ask IAudioClient3 for the minimum shared-mode
+        // engine period (down to ~2.6ms / 128 frames on capable drivers)
+        // and initialize with it. chunkSize is matched to the period so
+        // every event completes exactly one chunk - no accumulation
+        // carry-over in captureLoop. Any failure falls through to the
+        // classic Initialize below.
+        if (lowLatencyMode) {
+            ComPtr<IAudioClient3> audioClient3;
+            if (SUCCEEDED(audioClient.As(&audioClient3))) {
+                UINT32 defaultPeriod = 0, fundamentalPeriod = 0;
+                UINT32 minPeriod = 0, maxPeriod = 0;
+                hr = audioClient3->GetSharedModeEnginePeriod(
+                    &format, &defaultPeriod, &fundamentalPeriod,
+                    &minPeriod, &maxPeriod);
+                if (SUCCEEDED(hr) && minPeriod > 0) {
+                    hr = audioClient3->InitializeSharedAudioStream(
+                        streamFlags, minPeriod, &format, nullptr);
+                    if (SUCCEEDED(hr)) {
+                        initialized = true;
+                        negotiatedPeriodFrames = minPeriod;
+                        chunkSize = minPeriod;
+                        std::cout << "Low-latency mode: engine period "
+                                  << minPeriod << " frames" << std::endl;
+                    } else {
+                        std::cout << "InitializeSharedAudioStream failed (0x"
+                                  << std::hex << hr
+                                  << "), falling back to default period" << std::endl;
+                    }
+                } else {
+                    std::cout << "GetSharedModeEnginePeriod unavailable (0x"
+                              << std::hex << hr
+                              << "), falling back to default period" << std::endl;
+                }
+            } else {
+                std::cout << "IAudioClient3 not supported, falling back to "
+                             "default period" << std::endl;
+            }
+        }
+
         // Initialize with event callback flag
-        hr = audioClient->Initialize(
-            AUDCLNT_SHAREMODE_SHARED,
-            streamFlags,
-            0, 0,  // Must be 0 for event-driven
-            &format,
-            nullptr
-        );
-        
+        if (!initialized) {
+            hr = audioClient->Initialize(
+                AUDCLNT_SHAREMODE_SHARED,
+                streamFlags,
+                0, 0,  // Must be 0 for event-driven
+                &format,
+                nullptr
+            );
+        } else {
+            hr = S_OK;
+        }
+
         if (FAILED(hr)) {
             // Some systems might not support event-driven with Process Loopback
             // Fall back to polling mode
@@ -550,138 +1685,1725 @@ public:
             return false;
         }
         
+        // Build the resampler for this run (filter tables precomputed
+        // here, so the capture loop only multiply-accumulates)
+        if (resampleRate != 0) {
+            resampler = std::make_unique<PolyphaseResampler>(
+                48000, resampleRate, outputChannels());
+        } else {
+            resampler.reset();
+        }
+
         // Clear queue and reset metrics
         audioQueue.clear();
+        audioRing.clear();
         totalFramesCaptured = 0;
         totalSilentFrames = 0;
         captureErrors = 0;
         eventSignals = 0;
         timeouts = 0;
+        pendingGapFrames = 0;
+        suppressedChunks = 0;
+        nextSequenceFrame = 0;
+        meterAccPeak = 0.0f;
+        meterAccSumSq = 0.0;
+        meterAccSamples = 0;
+        meterPeak = 0.0f;
+        meterRms = 0.0f;
+        meterDiscardedChunks = 0;
+        {
+            // (Re)allocate the replay ring for this run's rate/channels;
+            // from here on the capture thread never allocates for replay
+            std::lock_guard<std::mutex> lock(replayMutex);
+            replayCapacityFrames = static_cast<size_t>(
+                replaySeconds * effectiveSampleRate());
+            replayBuffer.assign(replayCapacityFrames * outputChannels(), 0.0f);
+            replayWriteFrame = 0;
+            replayTotalFrames = 0;
+        }
+        eventToPushHist.reset();
+        queueResidencyHist.reset();
+        packetSizeHist.reset();
+        restarts = 0;
+        lastRecoveryUs = 0;
+        targetProcessExited = false;
+        memcpyBytes = 0;
+        // SYNCHRONIZE handle lets the wait set (and the polling watchdog)
+        // see target exit directly; meaningless in exclude mode, where the
+        // stream outlives the excluded process
+        if (targetProcessHandle) {
+            CloseHandle(targetProcessHandle);
+            targetProcessHandle = nullptr;
+        }
+        if (watchdogEnabled && !excludeProcessTree) {
+            targetProcessHandle = OpenProcess(SYNCHRONIZE, FALSE, processId);
+            if (!targetProcessHandle) {
+                std::cerr << "Watchdog: OpenProcess(SYNCHRONIZE) failed for PID "
+                          << processId << " - exit detection disabled" << std::endl;
+            }
+        }
+        lastEventTime = std::chrono::steady_clock::now();
         startTime = std::chrono::steady_clock::now();
         
-        // Start capture thread
+        // Start capture thread - binding a prewarmed slot if one is
+        // parked, otherwise spawning fresh
         shouldStop = false;
+        awaitingFirstChunk = true;
         capturing = true;
-        captureThread = std::thread(&QueueBasedProcessCapture::captureLoop, this);
-        
-        std::cout << "Capture started successfully!" << std::endl;
-        return true;
-    }
-    
-    void stop() {
-        if (!capturing.load()) {
-            return;
-        }
-        
-        shouldStop = true;
-        audioQueue.close();
-        
-        // Signal stop event if in event-driven mode
-        if (stopEvent) {
-            SetEvent(stopEvent);
+
+        std::unique_ptr<StandbySlot> slot;
+        {
+            std::lock_guard<std::mutex> lock(standbyMutex);
+            if (!standbySlots.empty()) {
+                slot = std::move(standbySlots.back());
+                standbySlots.pop_back();
+            }
         }
-        
+        // A watchdog-ended run leaves captureThread joinable if stop()
+        // was never called; assigning over a joinable thread terminates
         if (captureThread.joinable()) {
             captureThread.join();
         }
+        if (captureThreadHandle) {
+            // Handle from the previous run; this run gets its own
+            CloseHandle(captureThreadHandle);
+            captureThreadHandle = nullptr;
+        }
+        if (slot) {
+            captureThread = std::move(slot->thread);
+            SetEvent(slot->goEvent);
+            standbyBinds.fetch_add(1, std::memory_order_relaxed);
+            {
+                // Keep the slot (and its event handle) alive until the
+                // destructor; the parked thread may still be inside the wait
+                std::lock_guard<std::mutex> lock(standbyMutex);
+                retiredSlots.push_back(std::move(slot));
+            }
+            std::cout << "Capture started (prewarmed slot)" << std::endl;
+        } else {
+            captureThread = std::thread(&QueueBasedProcessCapture::captureLoop, this);
+            std::cout << "Capture started successfully!" << std::endl;
+        }
+
+        // Duplicate the thread handle so GetThreadTimes stays answerable
+        // even after the thread exits (std::thread's handle dies with join)
+        DuplicateHandle(GetCurrentProcess(),
+                        static_cast<HANDLE>(captureThread.native_handle()),
+                        GetCurrentProcess(), &captureThreadHandle,
+                        0, FALSE, DUPLICATE_SAME_ACCESS);
+        return true;
+    }
+
+    // Create standby slots until `count` are parked. Callable any time;
+    // slots survive stop() and are consumed one per start().
+    void prewarm(size_t count) {
+        std::lock_guard<std::mutex> lock(standbyMutex);
+        while (standbySlots.size() < count) {
+            auto slot = std::make_unique<StandbySlot>();
+            slot->goEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+            if (!slot->goEvent) {
+                std::cerr << "prewarm: CreateEvent failed" << std::endl;
+                break;
+            }
+            slot->thread = std::thread(&QueueBasedProcessCapture::standbyLoop,
+                                       this, slot.get());
+            standbySlots.push_back(std::move(slot));
+        }
+    }
+
+    size_t standbyCount() const {
+        std::lock_guard<std::mutex> lock(standbyMutex);
+        return standbySlots.size();
+    }
+    
+    // Non-blocking start: returns immediately while activation and
+    // Initialize run on a worker thread. Poll start_state() or block in
+    // wait_ready(). Starting captures for many PIDs now overlaps instead
+    // of serializing at several hundred ms each.
+    bool startAsync(DWORD processId, int timeoutMs = 10000) {
+        if (capturing.load() || startState.load() == kStartActivating) {
+            std::cerr << "Already capturing or activating" << std::endl;
+            return false;
+        }
+        if (asyncStartThread.joinable()) {
+            asyncStartThread.join();
+        }
+
+        cancelRequested = false;
+        setStartState(kStartActivating);
+
+        asyncStartThread = std::thread([this, processId, timeoutMs] {
+            bool ok = start(processId, timeoutMs);
+            if (ok) {
+                setStartState(kStartReady);
+            } else {
+                setStartState(cancelRequested.load() ? kStartCancelled : kStartFailed);
+            }
+        });
+        return true;
+    }
+
+    // Block until an async start resolves (or timeout). Returns true
+    // once the capture thread is running.
+    bool waitReady(int timeoutMs = 10000) {
+        std::unique_lock<std::mutex> lock(startStateMutex);
+        startStateCv.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                              [this] { return startState.load() != kStartActivating; });
+        return startState.load() == kStartReady;
+    }
+
+    // Abort an in-flight start (async or blocking). The activation wait
+    // loop observes the flag within ~50ms.
+    void cancel() {
+        cancelRequested = true;
+    }
+
+    std::string getStartState() const {
+        switch (startState.load()) {
+            case kStartActivating: return "activating";
+            case kStartReady: return "ready";
+            case kStartFailed: return "failed";
+            case kStartCancelled: return "cancelled";
+            default: return "idle";
+        }
+    }
+
+    void stop() {
+        // Abort and reap any in-flight async start first
+        if (startState.load() == kStartActivating) {
+            cancelRequested = true;
+        }
+        if (asyncStartThread.joinable()) {
+            asyncStartThread.join();
+        }
+        setStartState(kStartIdle);
+
+        // Finalize any active recording before tearing the capture down
+        stopRecording();
+
+        if (!capturing.load()) {
+            // Capture may have ended on its own (watchdog): the OS thread
+            // has exited but the std::thread stays joinable, and leaving
+            // it that way would terminate on the next start() assignment
+            // or in the destructor. Reap it - the join returns promptly.
+            if (captureThread.joinable()) {
+                captureThread.join();
+            }
+            if (targetProcessHandle) {
+                CloseHandle(targetProcessHandle);
+                targetProcessHandle = nullptr;
+            }
+            return;
+        }
+
+        shouldStop = true;
+        audioQueue.close();
+        audioRing.close();
         
-        capturing = false;
-        
+        // Signal stop event if in event-driven mode
+        if (stopEvent) {
+            SetEvent(stopEvent);
+        }
+        
+        if (captureThread.joinable()) {
+            captureThread.join();
+        }
+
+        capturing = false;
+
+        if (targetProcessHandle) {
+            CloseHandle(targetProcessHandle);
+            targetProcessHandle = nullptr;
+        }
+
         // Release COM objects
         captureClient.Reset();
         audioClient.Reset();
     }
-    
-    void setChunkSize(size_t frames) {
-        if (!capturing.load()) {
-            chunkSize = frames;
-            std::cout << "Chunk size set to " << frames << " frames" << std::endl;
+    
+    // Configure what the queue does when full. "oldest" favours live
+    // monitoring, "newest" favours contiguous recordings, "block" gives
+    // the consumer block_ms to make room before shedding the newest,
+    // "decimate" halves the rate evenly while saturated. In lock_free
+    // mode the ring is inherently drop-newest and cannot be changed.
+    void setDropPolicy(const std::string& policyName, int blockMs = 5) {
+        DropPolicy p;
+        if (policyName == "oldest") p = DropPolicy::DropOldest;
+        else if (policyName == "newest") p = DropPolicy::DropNewest;
+        else if (policyName == "block") p = DropPolicy::BlockWithDeadline;
+        else if (policyName == "decimate") p = DropPolicy::Decimate;
+        else {
+            std::cerr << "Unknown drop policy: " << policyName << std::endl;
+            return;
+        }
+
+        if (lockFreeMode) {
+            if (p != DropPolicy::DropNewest) {
+                std::cerr << "Lock-free ring only supports drop-newest" << std::endl;
+            }
+            return;
+        }
+        audioQueue.setDropPolicy(p, blockMs);
+    }
+
+    // Configure capture-thread level metering. window_ms sets the
+    // peak/RMS accumulation window and must be set before start();
+    // enabled/metering_only may be toggled at runtime. With
+    // metering_only=True chunks are discarded after metering - levels
+    // for 15 processes cost 15 SIMD scans, no queue or Python traffic.
+    void setMetering(bool enabled, bool meteringOnlyMode = false,
+                     uint32_t windowMs = 100) {
+        if (capturing.load()) {
+            if (windowMs != meterWindowMs) {
+                std::cerr << "metering window must be set before start" << std::endl;
+            }
+        } else {
+            meterWindowMs = windowMs ? windowMs : 100;
+        }
+        meteringEnabled = enabled;
+        meteringOnly = meteringOnlyMode;
+    }
+
+    // Latest finished metering window. O(1), never touches the queue.
+    py::dict getLevels() const {
+        py::dict levels;
+        levels["peak"] = meterPeak.load(std::memory_order_relaxed);
+        levels["rms"] = meterRms.load(std::memory_order_relaxed);
+        levels["window_ms"] = meterWindowMs;
+        levels["enabled"] = meteringEnabled.load();
+        levels["metering_only"] = meteringOnly.load();
+        return levels;
+    }
+
+    // Configure the replay window. seconds sizes the ring and must be
+    // set before start() (the buffer is allocated there, sized for the
+    // run's rate and channel count); replay_only may be toggled at
+    // runtime and discards chunks after the replay copy, so an always-on
+    // clip recorder costs one memcpy per chunk and nothing else.
+    void setReplay(double seconds, bool replayOnlyMode = false) {
+        if (capturing.load()) {
+            if (seconds != replaySeconds) {
+                std::cerr << "replay window must be set before start" << std::endl;
+            }
+        } else {
+            replaySeconds = seconds > 0 ? seconds : 0.0;
+        }
+        replayOnly = replayOnlyMode && replaySeconds > 0;
+    }
+
+    // Snapshot the replay window into one (N, channels) float32 array.
+    // first_frame is the absolute index of the first returned frame, on
+    // the same clock as chunk sequence numbers.
+    py::dict getReplay() {
+        std::vector<float> snap;
+        uint64_t firstFrame = 0;
+        size_t frames = 0;
+        {
+            py::gil_scoped_release release;
+            frames = snapshotReplay(snap, firstFrame);
+        }
+
+        const size_t channels = outputChannels();
+        py::array_t<float> arr({static_cast<py::ssize_t>(frames),
+                                static_cast<py::ssize_t>(channels)});
+        if (frames > 0) {
+            std::memcpy(arr.request().ptr, snap.data(),
+                        frames * channels * sizeof(float));
+        }
+
+        py::dict result;
+        result["data"] = arr;
+        result["frames"] = frames;
+        result["first_frame"] = firstFrame;
+        result["capacity_frames"] = replayCapacityFrames;
+        result["sample_rate"] = effectiveSampleRate();
+        return result;
+    }
+
+    // Snapshot the replay window straight to a WAV file (same formats as
+    // the recording sink). Returns the number of frames written.
+    size_t saveReplay(const std::string& path, const std::string& format = "int16") {
+        if (format != "int16" && format != "float32") {
+            std::cerr << "Unknown replay format: " << format << std::endl;
+            return 0;
+        }
+
+        std::vector<float> snap;
+        uint64_t firstFrame = 0;
+        size_t frames = snapshotReplay(snap, firstFrame);
+
+        FILE* file = nullptr;
+        if (fopen_s(&file, path.c_str(), "wb") != 0 || !file) {
+            std::cerr << "Failed to open replay file: " << path << std::endl;
+            return 0;
+        }
+        setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+        bool int16 = (format == "int16");
+        uint16_t formatTag = int16 ? WAVE_FORMAT_PCM : WAVE_FORMAT_IEEE_FLOAT;
+        uint16_t bits = int16 ? 16 : 32;
+        uint16_t fileChannels = static_cast<uint16_t>(outputChannels());
+        uint32_t fileRate = effectiveSampleRate();
+        size_t samples = frames * fileChannels;
+        uint32_t dataBytes = static_cast<uint32_t>(
+            samples * (int16 ? sizeof(int16_t) : sizeof(float)));
+        WriteWavHeader(file, formatTag, fileChannels, fileRate, bits, dataBytes);
+
+        size_t written = 0;
+        if (int16) {
+            std::vector<int16_t> conv(samples);
+            ConvertFloat32ToInt16(snap.data(), conv.data(), samples);
+            written = fwrite(conv.data(), sizeof(int16_t), samples, file);
+        } else {
+            written = fwrite(snap.data(), sizeof(float), samples, file);
+        }
+        fclose(file);
+
+        if (written != samples) {
+            std::cerr << "Short write saving replay to " << path << std::endl;
+            return written / fileChannels;
+        }
+        return frames;
+    }
+
+    // Configure the in-capture-thread transform stage. Must be called
+    // before start(); mono=True halves queue memory and downstream
+    // bandwidth, gain is applied in-place with the SSE2 kernel.
+    void setTransform(float gain = 1.0f, bool mono = false) {
+        if (capturing.load()) {
+            std::cerr << "set_transform must be called before start" << std::endl;
+            return;
+        }
+        transformGain = gain;
+        transformMono = mono;
+    }
+
+    // Configure the native resampler stage. Must be called before
+    // start(); rate=0 disables resampling. Chunks then arrive in the
+    // queue already at the target rate.
+    void setResampleRate(uint32_t rate) {
+        if (capturing.load()) {
+            std::cerr << "set_resample_rate must be called before start" << std::endl;
+            return;
+        }
+        resampleRate = (rate == 48000) ? 0 : rate;
+    }
+
+    // Map a named shared-memory section and mirror every emitted chunk
+    // into it, so a separate process can consume this capture without
+    // pybind11 crossings. Must be called while not capturing.
+    bool startShmExport(const std::string& name, size_t capacityFrames = 48000 * 5) {
+        if (capturing.load()) {
+            std::cerr << "start_shm_export must be called before start" << std::endl;
+            return false;
+        }
+        if (shmMapping) {
+            std::cerr << "Shared-memory export already active" << std::endl;
+            return false;
+        }
+
+        size_t channels = outputChannels();
+        size_t bytes = sizeof(ShmRingHeader) +
+                       capacityFrames * channels * sizeof(float);
+
+        shmMapping = CreateFileMappingA(
+            INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+            static_cast<DWORD>(bytes >> 32),
+            static_cast<DWORD>(bytes & 0xFFFFFFFF),
+            name.c_str());
+        if (!shmMapping) {
+            std::cerr << "CreateFileMapping failed: " << GetLastError() << std::endl;
+            return false;
+        }
+
+        void* view = MapViewOfFile(shmMapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if (!view) {
+            std::cerr << "MapViewOfFile failed: " << GetLastError() << std::endl;
+            CloseHandle(shmMapping);
+            shmMapping = nullptr;
+            return false;
+        }
+
+        ShmRingHeader* header = static_cast<ShmRingHeader*>(view);
+        header->magic = kShmMagic;
+        header->version = kShmVersion;
+        header->channels = static_cast<uint32_t>(channels);
+        header->sampleRate = effectiveSampleRate();
+        header->capacityFrames = capacityFrames;
+        header->totalFramesWritten.store(0, std::memory_order_release);
+
+        shmData = reinterpret_cast<float*>(
+            reinterpret_cast<char*>(view) + sizeof(ShmRingHeader));
+        shmHeader = header;
+        return true;
+    }
+
+    void stopShmExport() {
+        if (capturing.load()) {
+            std::cerr << "stop_shm_export must be called after stop" << std::endl;
+            return;
+        }
+        if (shmHeader) {
+            UnmapViewOfFile(shmHeader);
+            shmHeader = nullptr;
+            shmData = nullptr;
+        }
+        if (shmMapping) {
+            CloseHandle(shmMapping);
+            shmMapping = nullptr;
+        }
+    }
+
+    // Opt in to silence suppression: silent stretches become run-length
+    // gap records (start timestamp + frame count) instead of zero-filled
+    // buffers flowing through the queue. Must be called before start().
+    void setSilenceSuppression(bool enabled) {
+        if (capturing.load()) {
+            std::cerr << "set_silence_suppression must be called before start" << std::endl;
+            return;
+        }
+        suppressSilence = enabled;
+    }
+
+    void setChunkSize(size_t frames) {
+        if (!capturing.load()) {
+            chunkSize = frames;
+            std::cout << "Chunk size set to " << frames << " frames" << std::endl;
+        }
+    }
+
+    // Request IAudioClient3 small-buffer mode on the next start().
+    // chunkSize is auto-matched to the negotiated engine period, which
+    // overrides set_chunk_size; the period appears in get_metrics() as
+    // engine_period_frames. Falls back to the default ~10ms period when
+    // the driver or the loopback client does not support it.
+    void setLowLatency(bool enabled) {
+        if (capturing.load()) {
+            std::cerr << "set_low_latency must be called before start" << std::endl;
+            return;
+        }
+        lowLatencyMode = enabled;
+    }
+
+    // Flip the next start() to EXCLUDE_TARGET_PROCESS_TREE: the stream
+    // then carries every process except the target's tree. "Everything
+    // but Discord" becomes one capture stack instead of one per process.
+    void setExcludeProcessTree(bool enabled) {
+        if (capturing.load()) {
+            std::cerr << "set_exclude_process_tree must be called before start" << std::endl;
+            return;
+        }
+        excludeProcessTree = enabled;
+    }
+
+    // Arm the capture watchdog for the next start(): the capture thread
+    // supervises its own delivery (no frames for stall_ms, device
+    // invalidation, target-process exit) and reinitializes the audio
+    // client in place - COM, MMCSS and the event handles are reused, so
+    // the blackout is roughly one activation plus one engine period. Each
+    // recovery pushes a gap record sized to the outage so consumers see
+    // an exact discontinuity, not a silent hole.
+    void setWatchdog(bool enabled, uint32_t stallMs = 2000,
+                     uint32_t maxRestartCount = 5) {
+        if (capturing.load()) {
+            std::cerr << "set_watchdog must be called before start" << std::endl;
+            return;
+        }
+        if (enabled && stallMs == 0) {
+            std::cerr << "set_watchdog: stall_ms must be > 0" << std::endl;
+            return;
+        }
+        watchdogEnabled = enabled;
+        stallTimeoutMs = stallMs;
+        maxRestarts = maxRestartCount;
+    }
+
+    // Convert a chunk to the Python-facing dict. With copy=true the
+    // samples are memcpy'd into a fresh numpy array and the chunk buffer
+    // returns to the pool immediately. With copy=false the array is a
+    // zero-copy view over the pooled buffer: the buffer only returns to
+    // the pool when the array (and every view derived from it) is
+    // garbage-collected, so long-lived references shrink the pool and
+    // eventually force counted alloc-fallbacks.
+    py::dict chunkToDict(AudioChunk& chunk, bool copy, bool expandGaps = false) {
+        py::array_t<float> arr;
+        const py::ssize_t channels = static_cast<py::ssize_t>(chunk.channels);
+
+        if (chunk.gap) {
+            // Gap record: either synthesize the zeros on demand or hand
+            // the consumer the run-length record directly
+            py::ssize_t frames = expandGaps ? static_cast<py::ssize_t>(chunk.frameCount) : 0;
+            arr = py::array_t<float>({frames, channels});
+            if (frames > 0) {
+                std::memset(arr.request().ptr, 0,
+                            chunk.frameCount * chunk.channels * sizeof(float));
+            }
+
+            py::dict chunkDict;
+            chunkDict["data"] = arr;
+            chunkDict["silent"] = true;
+            chunkDict["gap_frames"] = chunk.frameCount;
+            chunkDict["sequence"] = chunk.sequence;
+            chunkDict["device_position"] = chunk.devicePosition;
+            chunkDict["qpc_time"] = chunk.qpcTime;
+            chunkDict["timestamp"] = std::chrono::duration_cast<std::chrono::microseconds>(
+                chunk.timestamp.time_since_epoch()).count();
+            return chunkDict;
+        }
+
+        if (copy) {
+            arr = py::array_t<float>({static_cast<py::ssize_t>(chunk.frameCount), channels});
+            auto ptr = static_cast<float*>(arr.request().ptr);
+            std::memcpy(ptr, chunk.data.data(),
+                        chunk.frameCount * chunk.channels * sizeof(float));
+            recycleChunk(chunk);
+        } else {
+            auto* holder = new PooledBufferHolder{std::move(chunk.data), chunkPool};
+            py::capsule base(holder, [](void* p) {
+                auto* h = static_cast<PooledBufferHolder*>(p);
+                h->pool->release(std::move(h->data));
+                delete h;
+            });
+            arr = py::array_t<float>(
+                {static_cast<py::ssize_t>(chunk.frameCount), channels},
+                {static_cast<py::ssize_t>(channels * sizeof(float)),
+                 static_cast<py::ssize_t>(sizeof(float))},
+                holder->data.data(),
+                base);
+        }
+
+        py::dict chunkDict;
+        chunkDict["data"] = arr;
+        chunkDict["silent"] = chunk.silent;
+        chunkDict["gap_frames"] = 0;
+        chunkDict["sequence"] = chunk.sequence;
+        chunkDict["device_position"] = chunk.devicePosition;
+        chunkDict["qpc_time"] = chunk.qpcTime;
+        chunkDict["timestamp"] = std::chrono::duration_cast<std::chrono::microseconds>(
+            chunk.timestamp.time_since_epoch()).count();
+        return chunkDict;
+    }
+
+    // Start the native recording sink. The writer thread becomes the
+    // queue consumer, so pop_chunks/pop_frames should not be called while
+    // a recording is active. format is "int16" (default, converted with
+    // the in-cache kernel) or "float32" (raw capture format) for WAV, or
+    // "flac" / "aac" for the compressed Media Foundation sink (give the
+    // path a matching .flac / .m4a extension - the container is chosen
+    // from it).
+    bool startRecording(const std::string& path, const std::string& format = "int16") {
+        if (recording.load()) {
+            std::cerr << "Already recording" << std::endl;
+            return false;
+        }
+        if (format == "int16" || format == "float32") {
+            recordCodec = kCodecWav;
+            recordInt16 = (format == "int16");
+        } else if (format == "flac") {
+            recordCodec = kCodecFlac;
+        } else if (format == "aac") {
+            recordCodec = kCodecAac;
+        } else {
+            std::cerr << "Unknown recording format: " << format
+                      << " (use int16, float32, flac or aac)" << std::endl;
+            return false;
+        }
+
+        recordingPath = path;
+        framesWritten = 0;
+        writeErrors = 0;
+        encoderCpuUs = 0;
+        stopRecordingFlag = false;
+        recording = true;
+        writerThread = std::thread(recordCodec == kCodecWav
+                                       ? &QueueBasedProcessCapture::writerLoop
+                                       : &QueueBasedProcessCapture::encoderLoop,
+                                   this);
+        return true;
+    }
+
+    // Bitrate knob for the lossy (AAC) sink. FLAC is lossless and has no
+    // rate to set. The Windows AAC encoder supports a small set of rates
+    // (96/128/160/192 kbps for stereo) and picks the nearest.
+    void setEncoderBitrate(uint32_t bitsPerSecond) {
+        if (recording.load()) {
+            std::cerr << "set_encoder_bitrate must be called before start_recording"
+                      << std::endl;
+            return;
+        }
+        encoderBitrate = bitsPerSecond;
+    }
+
+    // Stop the recording sink, finalize the WAV header and return the
+    // number of frames written
+    size_t stopRecording() {
+        if (!recording.load()) {
+            return framesWritten.load();
+        }
+
+        stopRecordingFlag = true;
+        if (writerThread.joinable()) {
+            writerThread.join();
+        }
+        recording = false;
+        return framesWritten.load();
+    }
+
+    bool isRecording() const {
+        return recording.load();
+    }
+
+    // Aggregated pop: coalesce as many queued chunks as fit into one
+    // contiguous (N, 2) float32 array. One allocation and one Python
+    // crossing per call instead of one per 10ms chunk, which matters at
+    // hundreds of chunks per second per stream.
+    py::dict popFrames(size_t maxFrames = 48000, int timeoutMs = 10) {
+        size_t maxChunks = maxFrames / chunkSize;
+        if (maxChunks == 0) maxChunks = 1;
+
+        // The wait inside popBatchInternal can block for timeout_ms on a
+        // condition variable - release the GIL so other Python threads
+        // keep running, and reacquire it before building the result
+        std::vector<AudioChunk> chunks;
+        {
+            py::gil_scoped_release release;
+            chunks = popBatchInternal(maxChunks, timeoutMs);
+        }
+
+        size_t totalFrames = 0;
+        size_t silentFrames = 0;
+        for (const auto& chunk : chunks) {
+            totalFrames += chunk.frameCount;
+            if (chunk.silent) silentFrames += chunk.frameCount;
+        }
+
+        const size_t channels = outputChannels();
+        py::array_t<float> arr({static_cast<py::ssize_t>(totalFrames),
+                                static_cast<py::ssize_t>(channels)});
+        if (totalFrames > 0) {
+            float* dst = static_cast<float*>(arr.request().ptr);
+            for (auto& chunk : chunks) {
+                size_t samples = chunk.frameCount * chunk.channels;
+                if (chunk.gap) {
+                    std::memset(dst, 0, samples * sizeof(float));
+                } else {
+                    std::memcpy(dst, chunk.data.data(), samples * sizeof(float));
+                }
+                dst += samples;
+                recycleChunk(chunk);
+            }
+        }
+
+        // A change in the dropped-chunk counter since the last aggregated
+        // pop means audio is missing inside or just before this batch
+        auto stats = lockFreeMode ? audioRing.getStats() : audioQueue.getStats();
+        size_t droppedNow = stats["dropped_chunks"];
+        bool discontinuity = (droppedNow != lastDroppedChunks);
+        lastDroppedChunks = droppedNow;
+
+        py::dict result;
+        result["data"] = arr;
+        result["frames"] = totalFrames;
+        result["chunks"] = chunks.size();
+        result["silent_frames"] = silentFrames;
+        result["first_timestamp"] = chunks.empty() ? 0LL
+            : std::chrono::duration_cast<std::chrono::microseconds>(
+                  chunks.front().timestamp.time_since_epoch()).count();
+        result["first_sequence"] = chunks.empty() ? 0ULL : chunks.front().sequence;
+        result["discontinuity"] = discontinuity;
+        return result;
+    }
+
+    // Python interface methods
+    py::list popChunks(size_t maxChunks = 10, int timeoutMs = 10, bool copy = true,
+                       bool expandGaps = false) {
+        std::vector<AudioChunk> chunks;
+        {
+            py::gil_scoped_release release;
+            chunks = popBatchInternal(maxChunks, timeoutMs);
+        }
+
+        py::list result;
+        for (auto& chunk : chunks) {
+            result.append(chunkToDict(chunk, copy, expandGaps));
+        }
+
+        return result;
+    }
+
+    py::object popChunk(int timeoutMs = 10, bool copy = true, bool expandGaps = false) {
+        std::vector<AudioChunk> batch;
+        {
+            py::gil_scoped_release release;
+            batch = popBatchInternal(1, timeoutMs);
+        }
+
+        if (batch.empty()) {
+            return py::none();
+        }
+
+        return chunkToDict(batch[0], copy, expandGaps);
+    }
+    
+    size_t queueSize() const {
+        return lockFreeMode ? audioRing.size() : audioQueue.size();
+    }
+    
+    bool isCapturing() const {
+        return capturing.load();
+    }
+    
+    py::dict getMetrics(bool detailed = false) const {
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - startTime).count();
+        
+        auto queueStats = lockFreeMode ? audioRing.getStats() : audioQueue.getStats();
+
+        py::dict metrics;
+        metrics["capturing"] = capturing.load();
+        metrics["total_frames"] = totalFramesCaptured.load();
+        metrics["total_silent_frames"] = totalSilentFrames.load();
+        metrics["capture_errors"] = captureErrors.load();
+        metrics["elapsed_seconds"] = elapsed;
+        metrics["queue_size"] = queueStats["queue_size"];
+        metrics["total_chunks"] = queueStats["total_chunks"];
+        metrics["dropped_chunks"] = queueStats["dropped_chunks"];
+        metrics["chunk_size"] = chunkSize;
+        metrics["lock_free"] = lockFreeMode;
+        metrics["low_latency"] = lowLatencyMode;
+        metrics["engine_period_frames"] = negotiatedPeriodFrames;
+        metrics["exclude_process_tree"] = excludeProcessTree;
+
+        metrics["watchdog"] = watchdogEnabled;
+        metrics["restarts"] = restarts.load();
+        metrics["last_recovery_us"] = lastRecoveryUs.load();
+        metrics["target_process_exited"] = targetProcessExited.load();
+
+        auto poolStats = chunkPool->getStats();
+        metrics["pool_size"] = poolStats["pool_size"];
+        metrics["pool_free"] = poolStats["pool_free"];
+        metrics["pool_outstanding"] = poolStats["pool_outstanding"];
+        metrics["pool_alloc_fallbacks"] = poolStats["pool_alloc_fallbacks"];
+
+        metrics["transform_gain"] = transformGain;
+        metrics["transform_mono"] = transformMono;
+        metrics["output_channels"] = outputChannels();
+        metrics["sample_rate"] = effectiveSampleRate();
+
+        metrics["silence_suppression"] = suppressSilence;
+        metrics["suppressed_chunks"] = suppressedChunks.load();
+
+        metrics["metering_enabled"] = meteringEnabled.load();
+        metrics["metering_only"] = meteringOnly.load();
+        metrics["meter_discarded_chunks"] = meterDiscardedChunks.load();
+
+        {
+            std::lock_guard<std::mutex> lock(replayMutex);
+            metrics["replay_capacity_frames"] = replayCapacityFrames;
+            metrics["replay_frames"] = (std::min)(
+                replayTotalFrames, static_cast<uint64_t>(replayCapacityFrames));
+        }
+        metrics["replay_only"] = replayOnly.load();
+
+        metrics["recording"] = recording.load();
+        metrics["frames_written"] = framesWritten.load();
+        metrics["write_errors"] = writeErrors.load();
+        metrics["recording_codec"] = recordCodec == kCodecFlac ? "flac"
+                                   : recordCodec == kCodecAac ? "aac" : "wav";
+        metrics["encoder_bitrate"] = encoderBitrate;
+        metrics["encoder_cpu_us"] = encoderCpuUs.load();
+
+        metrics["event_driven"] = eventDrivenMode;
+        metrics["event_signals"] = eventSignals.load();
+        metrics["timeouts"] = timeouts.load();
+
+        metrics["standby_slots"] = standbyCount();
+        metrics["standby_binds"] = standbyBinds.load();
+        metrics["attach_latency_us"] = attachLatencyUs.load();
+        
+        if (elapsed > 0) {
+            metrics["frames_per_second"] = totalFramesCaptured.load() / elapsed;
+        }
+
+        if (detailed) {
+            // Bucketed percentiles; values are bucket upper bounds
+            metrics["event_to_push_us"] = eventToPushHist.snapshot();
+            metrics["queue_residency_us"] = queueResidencyHist.snapshot();
+            metrics["packet_size_frames"] = packetSizeHist.snapshot();
+
+            // Resource self-profiling for capacity planning: what this
+            // stream costs the box (see also get_resource_summary())
+            metrics["capture_cpu_us"] = captureCpuUs();
+            metrics["queue_bytes"] = queueStats["held_bytes"];
+            metrics["peak_queue_depth"] = queueStats["peak_depth"];
+            metrics["pool_free_bytes"] = poolStats["pool_free_bytes"];
+            metrics["memcpy_bytes"] = memcpyBytes.load();
+        }
+
+        return metrics;
+    }
+
+    // Plain-struct view of what this instance costs, summable across
+    // instances without touching Python objects
+    struct ResourceUsage {
+        uint64_t cpuUs;
+        size_t queueBytes;
+        size_t peakQueueDepth;
+        size_t poolFreeBytes;
+        uint64_t memcpyBytes;
+        bool active;
+    };
+
+    ResourceUsage getResourceUsage() const {
+        auto queueStats = lockFreeMode ? audioRing.getStats() : audioQueue.getStats();
+        auto poolStats = chunkPool->getStats();
+        return { captureCpuUs(), queueStats["held_bytes"], queueStats["peak_depth"],
+                 poolStats["pool_free_bytes"], memcpyBytes.load(), capturing.load() };
+    }
+};
+
+// Aggregate the self-profiling numbers across every live capture
+// instance - "what is PyWAC costing this box right now" in one call,
+// for deciding whether it can take another stream
+static py::dict GetResourceSummary() {
+    std::lock_guard<std::mutex> lock(g_captureRegistryMutex);
+    uint64_t cpuUs = 0;
+    uint64_t copiedBytes = 0;
+    size_t queueBytes = 0;
+    size_t poolFreeBytes = 0;
+    size_t peakQueueDepth = 0;
+    size_t activeStreams = 0;
+    for (const auto* cap : g_captureRegistry) {
+        auto usage = cap->getResourceUsage();
+        cpuUs += usage.cpuUs;
+        copiedBytes += usage.memcpyBytes;
+        queueBytes += usage.queueBytes;
+        poolFreeBytes += usage.poolFreeBytes;
+        peakQueueDepth = (std::max)(peakQueueDepth, usage.peakQueueDepth);
+        if (usage.active) activeStreams++;
+    }
+
+    py::dict summary;
+    summary["instances"] = g_captureRegistry.size();
+    summary["active_streams"] = activeStreams;
+    summary["capture_cpu_us"] = cpuUs;
+    summary["queue_bytes"] = queueBytes;
+    summary["pool_free_bytes"] = poolFreeBytes;
+    summary["peak_queue_depth"] = peakQueueDepth;
+    summary["memcpy_bytes"] = copiedBytes;
+    return summary;
+}
+
+// Multi-process capture engine: multiplexes N process-loopback streams
+// onto a small fixed pool of worker threads instead of one MMCSS thread
+// per captured process. Each worker blocks in WaitForMultipleObjects
+// over the audioDataEvent handles of its assigned streams, so 10+
+// concurrent captures cost two threads and CPU scales with audio
+// actually delivered, not with stream count. Streams require
+// event-driven mode; chunk buffers come from one shared pool.
+class MultiProcessCaptureEngine {
+private:
+    struct Stream {
+        DWORD pid = 0;
+        ComPtr<IAudioClient> audioClient;
+        ComPtr<IAudioCaptureClient> captureClient;
+        HANDLE audioDataEvent = nullptr;
+        // shared_ptr: a consumer blocked in popChunks keeps the queue
+        // alive even if stop() clears the stream table mid-pop
+        std::shared_ptr<ThreadSafeAudioQueue> queue;
+        AudioChunk currentChunk;
+        size_t currentOffset = 0;
+        std::atomic<bool> active{false};
+        std::atomic<size_t> totalFrames{0};
+        std::atomic<size_t> silentFrames{0};
+        std::atomic<size_t> captureErrors{0};
+        std::atomic<size_t> eventSignals{0};
+    };
+
+    struct Worker {
+        std::thread thread;
+        HANDLE rebuildEvent = nullptr;  // Signaled when the stream set changes
+    };
+
+    std::vector<std::unique_ptr<Stream>> streams;
+    mutable std::mutex streamsMutex;
+    std::vector<std::unique_ptr<Worker>> workers;
+    HANDLE stopEvent = nullptr;
+    std::atomic<bool> shouldStop{false};
+    bool running = false;
+
+    std::shared_ptr<ChunkBufferPool> chunkPool;
+    size_t numThreads;
+    size_t queueSize;
+    size_t chunkSize;
+
+    AudioChunk makeChunk() {
+        AudioChunk chunk;
+        chunk.data = chunkPool->acquire(chunkSize * 2);
+        chunk.frameCount = chunkSize;
+        chunk.timestamp = std::chrono::steady_clock::now();
+        return chunk;
+    }
+
+    // Drain all pending WASAPI packets for one stream into its queue.
+    // Same chunk-accumulation logic as QueueBasedProcessCapture's
+    // captureLoop, but reentrant per stream.
+    void drainStream(Stream& s) {
+        UINT32 packetSize = 0;
+        HRESULT hr = s.captureClient->GetNextPacketSize(&packetSize);
+        if (FAILED(hr)) {
+            s.captureErrors++;
+            return;
+        }
+
+        while (packetSize != 0 && !shouldStop) {
+            BYTE* pData = nullptr;
+            UINT32 framesAvailable = 0;
+            DWORD flags = 0;
+            UINT64 devicePosition = 0;
+            UINT64 qpcPosition = 0;  // 100ns units
+
+            hr = s.captureClient->GetBuffer(&pData, &framesAvailable, &flags,
+                                            &devicePosition, &qpcPosition);
+
+            if (SUCCEEDED(hr)) {
+                bool isSilent = (flags & AUDCLNT_BUFFERFLAGS_SILENT) != 0;
+                if (isSilent) {
+                    s.silentFrames += framesAvailable;
+                }
+
+                float* floatData = reinterpret_cast<float*>(pData);
+                size_t framesToProcess = framesAvailable;
+                size_t sourceOffset = 0;
+
+                while (framesToProcess > 0) {
+                    size_t framesToCopy = (framesToProcess < (chunkSize - s.currentOffset))
+                        ? framesToProcess : (chunkSize - s.currentOffset);
+
+                    if (s.currentOffset == 0) {
+                        // First frame of this chunk: engine position and
+                        // QPC from GetBuffer, adjusted for split packets
+                        s.currentChunk.devicePosition = devicePosition + sourceOffset;
+                        s.currentChunk.qpcTime = qpcPosition +
+                            sourceOffset * 10000000ull / 48000;
+                    }
+
+                    if (!isSilent && floatData) {
+                        std::memcpy(
+                            s.currentChunk.data.data() + s.currentOffset * 2,
+                            floatData + sourceOffset * 2,
+                            framesToCopy * 2 * sizeof(float)
+                        );
+                    } else {
+                        std::memset(
+                            s.currentChunk.data.data() + s.currentOffset * 2,
+                            0,
+                            framesToCopy * 2 * sizeof(float)
+                        );
+                    }
+
+                    s.currentOffset += framesToCopy;
+                    sourceOffset += framesToCopy;
+                    framesToProcess -= framesToCopy;
+
+                    if (s.currentOffset >= chunkSize) {
+                        s.currentChunk.silent = isSilent;
+                        s.queue->push(std::move(s.currentChunk));
+                        s.currentChunk = makeChunk();
+                        s.currentOffset = 0;
+                    }
+                }
+
+                s.totalFrames += framesAvailable;
+
+                hr = s.captureClient->ReleaseBuffer(framesAvailable);
+                if (FAILED(hr)) {
+                    s.captureErrors++;
+                }
+            } else {
+                s.captureErrors++;
+            }
+
+            hr = s.captureClient->GetNextPacketSize(&packetSize);
+            if (FAILED(hr)) {
+                s.captureErrors++;
+                break;
+            }
+        }
+    }
+
+    void workerLoop(size_t workerIndex) {
+        HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        bool needsUninit = SUCCEEDED(hr);
+
+        // One MMCSS registration per worker, not per stream
+        DWORD taskIndex = 0;
+        HANDLE hTask = AvSetMmThreadCharacteristics(TEXT("Audio"), &taskIndex);
+
+        Worker& worker = *workers[workerIndex];
+
+        // Local snapshot of assigned streams, rebuilt on rebuildEvent
+        std::vector<Stream*> assigned;
+        std::vector<HANDLE> handles;
+
+        auto rebuild = [&]() {
+            assigned.clear();
+            handles.clear();
+            handles.push_back(stopEvent);
+            handles.push_back(worker.rebuildEvent);
+
+            std::lock_guard<std::mutex> lock(streamsMutex);
+            for (size_t i = 0; i < streams.size(); i++) {
+                // Round-robin assignment; WaitForMultipleObjects caps one
+                // wait set at 64 handles, which round-robin keeps us under
+                if (i % workers.size() != workerIndex) continue;
+                Stream* s = streams[i].get();
+                if (!s->active.load() || !s->audioDataEvent) continue;
+                if (handles.size() >= MAXIMUM_WAIT_OBJECTS) break;
+                assigned.push_back(s);
+                handles.push_back(s->audioDataEvent);
+            }
+        };
+
+        rebuild();
+
+        while (!shouldStop) {
+            DWORD waitResult = WaitForMultipleObjects(
+                static_cast<DWORD>(handles.size()), handles.data(), FALSE, 100);
+
+            if (waitResult == WAIT_OBJECT_0) {
+                break;  // Stop event
+            } else if (waitResult == WAIT_OBJECT_0 + 1) {
+                rebuild();
+            } else if (waitResult >= WAIT_OBJECT_0 + 2 &&
+                       waitResult < WAIT_OBJECT_0 + handles.size()) {
+                Stream* s = assigned[waitResult - WAIT_OBJECT_0 - 2];
+                if (s->active.load()) {
+                    s->eventSignals++;
+                    drainStream(*s);
+                }
+            }
+            // WAIT_TIMEOUT: loop around and re-check shouldStop
+        }
+
+        if (hTask) AvRevertMmThreadCharacteristics(hTask);
+        if (needsUninit) CoUninitialize();
+    }
+
+    void signalRebuild() {
+        for (auto& worker : workers) {
+            if (worker->rebuildEvent) SetEvent(worker->rebuildEvent);
         }
     }
-    
-    // Python interface methods
-    py::list popChunks(size_t maxChunks = 10, int timeoutMs = 10) {
+
+    void ensureWorkersRunning() {
+        if (running) return;
+
+        shouldStop = false;
+        stopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+        for (size_t i = 0; i < numThreads; i++) {
+            auto worker = std::make_unique<Worker>();
+            worker->rebuildEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+            workers.push_back(std::move(worker));
+        }
+        for (size_t i = 0; i < numThreads; i++) {
+            workers[i]->thread = std::thread(&MultiProcessCaptureEngine::workerLoop, this, i);
+        }
+
+        running = true;
+    }
+
+public:
+    MultiProcessCaptureEngine(size_t num_threads = 2, size_t queue_size = 1000,
+                              size_t chunk_size = 480, size_t pool_size = 256)
+        : chunkPool(std::make_shared<ChunkBufferPool>(pool_size, chunk_size * 2)),
+          numThreads(num_threads == 0 ? 1 : num_threads),
+          queueSize(queue_size), chunkSize(chunk_size) {}
+
+    ~MultiProcessCaptureEngine() {
+        stop();
+    }
+
+    // Add a process-loopback stream; returns the stream id, or -1 on
+    // failure. The engine requires event-driven mode - there is no
+    // polling fallback because workers block in WaitForMultipleObjects.
+    int addStream(DWORD processId) {
+        HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        bool needsUninit = SUCCEEDED(hr);
+
+        auto stream = std::make_unique<Stream>();
+        stream->pid = processId;
+        stream->queue = std::make_shared<ThreadSafeAudioQueue>(queueSize);
+
+        bool ok = false;
+        do {
+            if (!ActivateProcessLoopbackClient(processId, stream->audioClient)) break;
+
+            WAVEFORMATEX format = ProcessLoopbackFormat();
+            hr = stream->audioClient->Initialize(
+                AUDCLNT_SHAREMODE_SHARED,
+                AUDCLNT_STREAMFLAGS_LOOPBACK | AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
+                0, 0, &format, nullptr);
+            if (FAILED(hr)) {
+                std::cerr << "Engine: event-driven Initialize failed: 0x"
+                          << std::hex << hr << std::endl;
+                break;
+            }
+
+            stream->audioDataEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+            if (!stream->audioDataEvent) break;
+
+            hr = stream->audioClient->SetEventHandle(stream->audioDataEvent);
+            if (FAILED(hr)) {
+                std::cerr << "Engine: SetEventHandle failed: 0x" << std::hex << hr << std::endl;
+                break;
+            }
+
+            hr = stream->audioClient->GetService(
+                __uuidof(IAudioCaptureClient),
+                reinterpret_cast<void**>(stream->captureClient.GetAddressOf()));
+            if (FAILED(hr)) break;
+
+            stream->currentChunk = makeChunk();
+            stream->currentOffset = 0;
+
+            hr = stream->audioClient->Start();
+            if (FAILED(hr)) break;
+
+            ok = true;
+        } while (false);
+
+        if (!ok) {
+            if (stream->audioDataEvent) CloseHandle(stream->audioDataEvent);
+            if (needsUninit) CoUninitialize();
+            return -1;
+        }
+
+        stream->active = true;
+
+        int streamId;
+        {
+            std::lock_guard<std::mutex> lock(streamsMutex);
+            streamId = static_cast<int>(streams.size());
+            streams.push_back(std::move(stream));
+        }
+
+        ensureWorkersRunning();
+        signalRebuild();
+
+        if (needsUninit) CoUninitialize();
+        return streamId;
+    }
+
+    // Deactivate a stream. The slot stays allocated (stream ids are
+    // stable) but workers drop it from their wait sets and the WASAPI
+    // client is stopped.
+    bool removeStream(int streamId) {
+        std::lock_guard<std::mutex> lock(streamsMutex);
+        if (streamId < 0 || streamId >= static_cast<int>(streams.size())) {
+            return false;
+        }
+
+        Stream& s = *streams[streamId];
+        if (!s.active.exchange(false)) {
+            return false;
+        }
+
+        if (s.audioClient) s.audioClient->Stop();
+        s.queue->close();
+        signalRebuild();
+        return true;
+    }
+
+    py::list popChunks(int streamId, size_t maxChunks = 10, int timeoutMs = 10) {
+        // Take a reference under the lock: popBatch can block for
+        // timeoutMs with the GIL released, and a concurrent stop() clears
+        // the stream table - the shared_ptr keeps the queue alive (and
+        // stop() closes it, so a blocked pop wakes promptly)
+        std::shared_ptr<ThreadSafeAudioQueue> queue;
+        {
+            std::lock_guard<std::mutex> lock(streamsMutex);
+            if (streamId < 0 || streamId >= static_cast<int>(streams.size())) {
+                return py::list();
+            }
+            queue = streams[streamId]->queue;
+        }
+
+        std::vector<AudioChunk> chunks;
+        {
+            py::gil_scoped_release release;
+            chunks = queue->popBatch(maxChunks, timeoutMs);
+        }
+
         py::list result;
-        
-        auto chunks = audioQueue.popBatch(maxChunks, timeoutMs);
-        
         for (auto& chunk : chunks) {
-            // Create numpy array from chunk data
-            py::array_t<float> arr({static_cast<py::ssize_t>(chunk.frameCount), static_cast<py::ssize_t>(2)});
+            py::array_t<float> arr({static_cast<py::ssize_t>(chunk.frameCount),
+                                    static_cast<py::ssize_t>(2)});
             auto ptr = static_cast<float*>(arr.mutable_unchecked<2>().mutable_data(0, 0));
             std::memcpy(ptr, chunk.data.data(), chunk.frameCount * 2 * sizeof(float));
-            
-            // Create dictionary with chunk metadata
+
             py::dict chunkDict;
             chunkDict["data"] = arr;
             chunkDict["silent"] = chunk.silent;
+            chunkDict["device_position"] = chunk.devicePosition;
+            chunkDict["qpc_time"] = chunk.qpcTime;
             chunkDict["timestamp"] = std::chrono::duration_cast<std::chrono::microseconds>(
                 chunk.timestamp.time_since_epoch()).count();
-            
             result.append(chunkDict);
+
+            chunkPool->release(std::move(chunk.data));
         }
-        
+
         return result;
     }
-    
-    py::object popChunk(int timeoutMs = 10) {
-        auto chunk = audioQueue.pop(timeoutMs);
-        
-        if (!chunk) {
-            return py::none();
+
+    void stop() {
+        if (!running) return;
+
+        shouldStop = true;
+        if (stopEvent) SetEvent(stopEvent);
+
+        for (auto& worker : workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+            if (worker->rebuildEvent) {
+                CloseHandle(worker->rebuildEvent);
+            }
         }
-        
-        // Create numpy array
-        py::array_t<float> arr({static_cast<py::ssize_t>(chunk->frameCount), static_cast<py::ssize_t>(2)});
-        auto ptr = static_cast<float*>(arr.mutable_unchecked<2>().mutable_data(0, 0));
-        std::memcpy(ptr, chunk->data.data(), chunk->frameCount * 2 * sizeof(float));
-        
-        // Create dictionary with chunk metadata
-        py::dict chunkDict;
-        chunkDict["data"] = arr;
-        chunkDict["silent"] = chunk->silent;
-        chunkDict["timestamp"] = std::chrono::duration_cast<std::chrono::microseconds>(
-            chunk->timestamp.time_since_epoch()).count();
-        
-        return chunkDict;
+        workers.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(streamsMutex);
+            for (auto& stream : streams) {
+                if (stream->active.exchange(false) && stream->audioClient) {
+                    stream->audioClient->Stop();
+                }
+                if (stream->queue) stream->queue->close();
+                if (stream->audioDataEvent) {
+                    CloseHandle(stream->audioDataEvent);
+                    stream->audioDataEvent = nullptr;
+                }
+                stream->captureClient.Reset();
+                stream->audioClient.Reset();
+            }
+            streams.clear();
+        }
+
+        if (stopEvent) {
+            CloseHandle(stopEvent);
+            stopEvent = nullptr;
+        }
+        running = false;
     }
-    
+
+    size_t streamCount() const {
+        std::lock_guard<std::mutex> lock(streamsMutex);
+        size_t count = 0;
+        for (const auto& stream : streams) {
+            if (stream->active.load()) count++;
+        }
+        return count;
+    }
+
+    py::dict getMetrics() const {
+        py::dict metrics;
+        metrics["num_threads"] = numThreads;
+        metrics["running"] = running;
+
+        auto poolStats = chunkPool->getStats();
+        metrics["pool_free"] = poolStats["pool_free"];
+        metrics["pool_alloc_fallbacks"] = poolStats["pool_alloc_fallbacks"];
+
+        py::list streamList;
+        {
+            std::lock_guard<std::mutex> lock(streamsMutex);
+            for (size_t i = 0; i < streams.size(); i++) {
+                const Stream& s = *streams[i];
+                py::dict d;
+                d["stream_id"] = i;
+                d["pid"] = s.pid;
+                d["active"] = s.active.load();
+                d["total_frames"] = s.totalFrames.load();
+                d["silent_frames"] = s.silentFrames.load();
+                d["capture_errors"] = s.captureErrors.load();
+                d["event_signals"] = s.eventSignals.load();
+                auto queueStats = s.queue->getStats();
+                d["queue_size"] = queueStats["queue_size"];
+                d["dropped_chunks"] = queueStats["dropped_chunks"];
+                streamList.append(d);
+            }
+        }
+        metrics["streams"] = streamList;
+
+        return metrics;
+    }
+};
+
+// Native multi-stream mixer: a worker thread drains N capture queues in
+// C++, keeps each stream's samples in a pending buffer, and sums them
+// chunk by chunk with per-stream gain (fused SIMD multiply-add). The
+// result is one Python-facing stream with the usual pop_chunks
+// interface - one GIL crossing instead of N, and no Python-side
+// alignment. Streams are sample-aligned from start(): all source queues
+// are flushed so every stream begins within one WASAPI period, and the
+// shared 48kHz engine clock keeps them aligned from there. A stream that
+// stalls (its process went quiet in a way suppression doesn't cover, or
+// its capture stopped) is zero-filled once the fastest stream runs
+// kMaxLagFrames ahead, so one dead input can never freeze the mix.
+class StreamMixer {
+private:
+    struct MixStream {
+        QueueBasedProcessCapture* capture = nullptr;
+        std::atomic<float> gain{1.0f};
+        std::vector<float> pending;  // Mix thread only
+        size_t pendingOffset = 0;    // Mix thread only
+        std::atomic<size_t> starvedFrames{0};
+    };
+
+    std::vector<std::unique_ptr<MixStream>> streams;
+    ThreadSafeAudioQueue outQueue;
+    size_t chunkFrames;
+    uint32_t channels = 2;
+    std::thread mixThread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> shouldStop{false};
+    uint64_t mixedFrames = 0;  // Mix thread only
+    std::atomic<size_t> mixedChunks{0};
+
+    // How far (in frames) the fastest stream may run ahead before
+    // starved streams are zero-filled: 100ms at 48kHz
+    static const size_t kMaxLagFrames = 4800;
+
+    void compact(MixStream& s) {
+        if (s.pendingOffset > 0 && s.pendingOffset >= s.pending.size() / 2) {
+            s.pending.erase(s.pending.begin(),
+                            s.pending.begin() + s.pendingOffset);
+            s.pendingOffset = 0;
+        }
+    }
+
+    void drainInto(MixStream& s) {
+        auto chunks = s.capture->popBatchInternal(16, 0);
+        for (auto& chunk : chunks) {
+            size_t samples = chunk.frameCount * chunk.channels;
+            if (chunk.gap) {
+                // Gap records become the zeros they stand for
+                s.pending.insert(s.pending.end(), samples, 0.0f);
+            } else {
+                s.pending.insert(s.pending.end(), chunk.data.begin(),
+                                 chunk.data.begin() + samples);
+                s.capture->recycleChunk(chunk);
+            }
+        }
+    }
+
+    void mixLoop() {
+        const size_t chunkSamples = chunkFrames * channels;
+
+        while (!shouldStop) {
+            for (auto& s : streams) {
+                drainInto(*s);
+            }
+
+            while (true) {
+                size_t minAvail = SIZE_MAX, maxAvail = 0;
+                for (auto& s : streams) {
+                    size_t avail = s->pending.size() - s->pendingOffset;
+                    if (avail < minAvail) minAvail = avail;
+                    if (avail > maxAvail) maxAvail = avail;
+                }
+
+                bool zeroFillStarved = maxAvail >= kMaxLagFrames * channels;
+                if (minAvail < chunkSamples &&
+                    !(zeroFillStarved && maxAvail >= chunkSamples)) {
+                    break;
+                }
+
+                AudioChunk out;
+                out.data.assign(chunkSamples, 0.0f);
+                out.frameCount = chunkFrames;
+                out.channels = channels;
+                out.sequence = mixedFrames;
+                out.timestamp = std::chrono::steady_clock::now();
+
+                for (auto& s : streams) {
+                    size_t avail = s->pending.size() - s->pendingOffset;
+                    float gain = s->gain.load(std::memory_order_relaxed);
+                    size_t take = avail < chunkSamples ? avail : chunkSamples;
+                    if (take > 0) {
+                        MixAccumulate(out.data.data(),
+                                      s->pending.data() + s->pendingOffset,
+                                      take, gain);
+                        s->pendingOffset += take;
+                    }
+                    if (take < chunkSamples) {
+                        s->starvedFrames.fetch_add((chunkSamples - take) / channels,
+                                                   std::memory_order_relaxed);
+                    }
+                    compact(*s);
+                }
+
+                mixedFrames += chunkFrames;
+                mixedChunks.fetch_add(1, std::memory_order_relaxed);
+                outQueue.push(std::move(out));
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+
+public:
+    StreamMixer(size_t chunk_frames = 480, size_t queue_size = 1000)
+        : outQueue(queue_size), chunkFrames(chunk_frames) {}
+
+    ~StreamMixer() {
+        stop();
+    }
+
+    // Register a capture as a mix input. Must be called before start();
+    // the capture object must outlive the mixer (enforced from Python
+    // via keep_alive on the binding).
+    int addStream(QueueBasedProcessCapture& capture, float gain = 1.0f) {
+        if (running.load()) {
+            std::cerr << "add_stream must be called before start" << std::endl;
+            return -1;
+        }
+        auto stream = std::make_unique<MixStream>();
+        stream->capture = &capture;
+        stream->gain = gain;
+        streams.push_back(std::move(stream));
+        return static_cast<int>(streams.size() - 1);
+    }
+
+    // Adjust a stream's gain while mixing (relaxed atomic, applied on
+    // the next chunk)
+    void setGain(int streamId, float gain) {
+        if (streamId < 0 || streamId >= static_cast<int>(streams.size())) {
+            std::cerr << "Invalid stream id: " << streamId << std::endl;
+            return;
+        }
+        streams[streamId]->gain = gain;
+    }
+
+    bool start() {
+        if (running.load()) {
+            std::cerr << "Mixer already running" << std::endl;
+            return false;
+        }
+        if (streams.empty()) {
+            std::cerr << "No streams added" << std::endl;
+            return false;
+        }
+
+        // All inputs must share a channel layout
+        channels = streams.front()->capture->outputChannels();
+        for (auto& s : streams) {
+            if (s->capture->outputChannels() != channels) {
+                std::cerr << "All mixer inputs must have the same channel count"
+                          << std::endl;
+                return false;
+            }
+        }
+
+        // Flush everything queued so the streams start sample-aligned:
+        // from here on the shared engine clock keeps them in step
+        for (auto& s : streams) {
+            auto stale = s->capture->popBatchInternal(1 << 20, 0);
+            for (auto& chunk : stale) {
+                if (!chunk.gap) s->capture->recycleChunk(chunk);
+            }
+            s->pending.clear();
+            s->pendingOffset = 0;
+            s->starvedFrames = 0;
+        }
+
+        outQueue.clear();
+        mixedFrames = 0;
+        mixedChunks = 0;
+        shouldStop = false;
+        running = true;
+        mixThread = std::thread(&StreamMixer::mixLoop, this);
+        return true;
+    }
+
+    void stop() {
+        if (!running.load()) return;
+        shouldStop = true;
+        if (mixThread.joinable()) {
+            mixThread.join();
+        }
+        running = false;
+    }
+
+    // Same shape as QueueBasedProcessCapture.pop_chunks (mixed chunks
+    // are always fresh copies - no pooled-view aliasing to manage)
+    py::list popChunks(size_t maxChunks = 10, int timeoutMs = 10) {
+        std::vector<AudioChunk> chunks;
+        {
+            py::gil_scoped_release release;
+            chunks = outQueue.popBatch(maxChunks, timeoutMs);
+        }
+
+        py::list result;
+        for (auto& chunk : chunks) {
+            py::array_t<float> arr({static_cast<py::ssize_t>(chunk.frameCount),
+                                    static_cast<py::ssize_t>(chunk.channels)});
+            std::memcpy(arr.request().ptr, chunk.data.data(),
+                        chunk.frameCount * chunk.channels * sizeof(float));
+
+            py::dict chunkDict;
+            chunkDict["data"] = arr;
+            chunkDict["sequence"] = chunk.sequence;
+            chunkDict["timestamp"] = std::chrono::duration_cast<std::chrono::microseconds>(
+                chunk.timestamp.time_since_epoch()).count();
+            result.append(chunkDict);
+        }
+
+        return result;
+    }
+
     size_t queueSize() const {
-        return audioQueue.size();
+        return outQueue.size();
     }
-    
-    bool isCapturing() const {
-        return capturing.load();
+
+    bool isRunning() const {
+        return running.load();
     }
-    
+
     py::dict getMetrics() const {
-        auto now = std::chrono::steady_clock::now();
-        double elapsed = std::chrono::duration<double>(now - startTime).count();
-        
-        auto queueStats = audioQueue.getStats();
-        
+        auto queueStats = outQueue.getStats();
+
         py::dict metrics;
-        metrics["capturing"] = capturing.load();
-        metrics["total_frames"] = totalFramesCaptured.load();
-        metrics["total_silent_frames"] = totalSilentFrames.load();
-        metrics["capture_errors"] = captureErrors.load();
-        metrics["elapsed_seconds"] = elapsed;
+        metrics["running"] = running.load();
+        metrics["num_streams"] = streams.size();
+        metrics["channels"] = channels;
+        metrics["chunk_frames"] = chunkFrames;
+        metrics["mixed_chunks"] = mixedChunks.load();
         metrics["queue_size"] = queueStats["queue_size"];
-        metrics["total_chunks"] = queueStats["total_chunks"];
         metrics["dropped_chunks"] = queueStats["dropped_chunks"];
-        metrics["chunk_size"] = chunkSize;
-        metrics["event_driven"] = eventDrivenMode;
-        metrics["event_signals"] = eventSignals.load();
-        metrics["timeouts"] = timeouts.load();
-        
-        if (elapsed > 0) {
-            metrics["frames_per_second"] = totalFramesCaptured.load() / elapsed;
+
+        py::list streamList;
+        for (size_t i = 0; i < streams.size(); i++) {
+            py::dict s;
+            s["stream_id"] = i;
+            s["gain"] = streams[i]->gain.load();
+            s["starved_frames"] = streams[i]->starvedFrames.load();
+            streamList.append(s);
         }
-        
+        metrics["streams"] = streamList;
         return metrics;
     }
 };
 
+// Reader side of the shared-memory transport: attach to a section
+// exported by start_shm_export (typically from another process) and pull
+// new frames as they are published. The reader keeps its own cursor;
+// falling more than one ring-lap behind is detected as an overrun and
+// the cursor jumps forward. Frames are copied out of the ring into the
+// returned array - a live view over memory the writer keeps recycling
+// would be silently corrupted a lap later, so the single memcpy here is
+// the price of a stable result.
+class ShmCaptureReader {
+private:
+    HANDLE mapping = nullptr;
+    ShmRingHeader* header = nullptr;
+    const float* data = nullptr;
+    uint64_t cursor = 0;
+    uint64_t overruns = 0;
+
+public:
+    ShmCaptureReader(const std::string& name) {
+        mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+        if (!mapping) {
+            throw std::runtime_error("Failed to open shared-memory section: " + name);
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping);
+            mapping = nullptr;
+            throw std::runtime_error("Failed to map shared-memory section: " + name);
+        }
+
+        header = static_cast<ShmRingHeader*>(view);
+        if (header->magic != kShmMagic || header->version != kShmVersion) {
+            UnmapViewOfFile(view);
+            CloseHandle(mapping);
+            mapping = nullptr;
+            header = nullptr;
+            throw std::runtime_error("Shared-memory section has unexpected layout: " + name);
+        }
+
+        data = reinterpret_cast<const float*>(
+            reinterpret_cast<const char*>(view) + sizeof(ShmRingHeader));
+
+        // Start from "now" rather than replaying whatever is in the ring
+        cursor = header->totalFramesWritten.load(std::memory_order_acquire);
+    }
+
+    ~ShmCaptureReader() {
+        if (header) UnmapViewOfFile(header);
+        if (mapping) CloseHandle(mapping);
+    }
+
+    // Pull up to max_frames new frames. Returns a dict with the (N, ch)
+    // array, the absolute start frame, and the cumulative overrun count.
+    py::dict read(size_t maxFrames = 48000) {
+        uint64_t w = header->totalFramesWritten.load(std::memory_order_acquire);
+        uint64_t cap = header->capacityFrames;
+        size_t stride = header->channels;
+
+        if (w - cursor > cap) {
+            overruns++;
+            cursor = w - cap;
+        }
+
+        uint64_t startFrame = cursor;
+        size_t frames = static_cast<size_t>((std::min)(
+            w - cursor, static_cast<uint64_t>(maxFrames)));
+
+        py::array_t<float> arr({static_cast<py::ssize_t>(frames),
+                                static_cast<py::ssize_t>(stride)});
+        if (frames > 0) {
+            float* dst = static_cast<float*>(arr.request().ptr);
+            uint64_t pos = cursor % cap;
+            size_t first = static_cast<size_t>((std::min)(
+                static_cast<uint64_t>(frames), cap - pos));
+            std::memcpy(dst, data + pos * stride, first * stride * sizeof(float));
+            if (frames > first) {
+                std::memcpy(dst + first * stride, data,
+                            (frames - first) * stride * sizeof(float));
+            }
+            cursor += frames;
+
+            // If the writer lapped us during the copy, the oldest frames
+            // we read may have been overwritten mid-copy
+            uint64_t w2 = header->totalFramesWritten.load(std::memory_order_acquire);
+            if (w2 - startFrame > cap) {
+                overruns++;
+            }
+        }
+
+        py::dict result;
+        result["data"] = arr;
+        result["start_frame"] = startFrame;
+        result["overruns"] = overruns;
+        return result;
+    }
+
+    py::dict info() const {
+        py::dict d;
+        d["channels"] = header->channels;
+        d["sample_rate"] = header->sampleRate;
+        d["capacity_frames"] = header->capacityFrames;
+        d["total_frames_written"] = header->totalFramesWritten.load(std::memory_order_acquire);
+        d["overruns"] = overruns;
+        return d;
+    }
+};
+
 // Helper function to list audio processes
 std::vector<ProcessInfo> listAudioProcesses() {
     std::vector<ProcessInfo> processes;
@@ -735,27 +3457,258 @@ PYBIND11_MODULE(capture, m) {
     
     // Queue-based capture class
     py::class_<QueueBasedProcessCapture>(m, "QueueBasedProcessCapture")
-        .def(py::init<size_t>(), py::arg("queue_size") = 1000)
+        .def(py::init<size_t, bool, size_t>(),
+             py::arg("queue_size") = 1000, py::arg("lock_free") = false,
+             py::arg("pool_size") = 64,
+             "Create a capture instance. With lock_free=True chunks flow through\n"
+             "a single-producer/single-consumer ring buffer so the capture thread\n"
+             "never blocks on a mutex held by Python. pool_size controls how many\n"
+             "chunk buffers are kept preallocated for reuse; size it from the\n"
+             "pool_alloc_fallbacks metric.")
         .def("start", &QueueBasedProcessCapture::start, py::arg("process_id"),
-             "Start capturing audio from the specified process")
+             py::arg("timeout_ms") = 10000,
+             py::call_guard<py::gil_scoped_release>(),
+             "Start capturing audio from the specified process. Blocks at\n"
+             "most timeout_ms waiting for activation (GIL released);\n"
+             "cancellable from another thread via cancel().")
+        .def("start_async", &QueueBasedProcessCapture::startAsync,
+             py::arg("process_id"), py::arg("timeout_ms") = 10000,
+             py::call_guard<py::gil_scoped_release>(),
+             "Start capture without blocking: activation runs on a worker\n"
+             "thread. Observe progress via start_state() / wait_ready().")
+        .def("wait_ready", &QueueBasedProcessCapture::waitReady,
+             py::arg("timeout_ms") = 10000,
+             py::call_guard<py::gil_scoped_release>(),
+             "Block (GIL released) until an async start resolves; returns\n"
+             "True once capturing")
+        .def("cancel", &QueueBasedProcessCapture::cancel,
+             "Abort an in-flight start (async or blocking)")
+        .def("prewarm", &QueueBasedProcessCapture::prewarm, py::arg("count"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Park `count` standby capture threads (COM apartment up) so\n"
+             "start() binds one instead of spawning; attach_latency_us in\n"
+             "get_metrics() reports start-to-first-chunk time")
+        .def("standby_count", &QueueBasedProcessCapture::standbyCount,
+             "Number of parked standby slots")
+        .def("start_state", &QueueBasedProcessCapture::getStartState,
+             "Async start state: idle / activating / ready / failed / cancelled")
         .def("stop", &QueueBasedProcessCapture::stop,
-             "Stop audio capture")
+             py::call_guard<py::gil_scoped_release>(),
+             "Stop audio capture (GIL released while joining the capture\n"
+             "and writer threads)")
         .def("set_chunk_size", &QueueBasedProcessCapture::setChunkSize, py::arg("frames"),
              "Set the chunk size in frames (must be called before start)")
-        .def("pop_chunks", &QueueBasedProcessCapture::popChunks, 
+        .def("set_low_latency", &QueueBasedProcessCapture::setLowLatency,
+             py::arg("enabled"),
+             "Negotiate the minimum WASAPI engine period via IAudioClient3\n"
+             "on the next start (down to ~2.6ms where supported) with the\n"
+             "chunk size matched to the period. Check engine_period_frames\n"
+             "in get_metrics(); 0 means the default period is in use.")
+        .def("set_exclude_process_tree", &QueueBasedProcessCapture::setExcludeProcessTree,
+             py::arg("enabled"),
+             "Capture everything EXCEPT the target process tree on the\n"
+             "next start (PROCESS_LOOPBACK_MODE_EXCLUDE_TARGET_PROCESS_\n"
+             "TREE) - 'all but one app' in a single stream. Must be called\n"
+             "before start; see pywac.open_capture for set-based planning.")
+        .def("set_watchdog", &QueueBasedProcessCapture::setWatchdog,
+             py::arg("enabled"), py::arg("stall_ms") = 2000,
+             py::arg("max_restarts") = 5,
+             "Supervise the capture from inside the capture thread: if no\n"
+             "frames arrive for stall_ms, the device is invalidated, or the\n"
+             "target process exits, the audio client is reinitialized in\n"
+             "place (up to max_restarts). Each recovery pushes a gap record\n"
+             "sized to the outage; restarts / last_recovery_us /\n"
+             "target_process_exited are reported in get_metrics(). Must be\n"
+             "called before start.")
+        .def("set_drop_policy", &QueueBasedProcessCapture::setDropPolicy,
+             py::arg("policy"), py::arg("block_ms") = 5,
+             "Queue-full behaviour: 'oldest' (default, live monitoring),\n"
+             "'newest' (contiguous recording), 'block' (wait block_ms for\n"
+             "space, then shed newest) or 'decimate' (keep every other\n"
+             "chunk while saturated). Chunk dicts carry a 'sequence' frame\n"
+             "index, so any drop is a detectable, exactly sized hole.\n"
+             "Not applicable in lock_free mode (ring is drop-newest).")
+        .def("start_shm_export", &QueueBasedProcessCapture::startShmExport,
+             py::arg("name"), py::arg("capacity_frames") = 48000 * 5,
+             "Mirror captured chunks into a named shared-memory ring so a\n"
+             "separate process can consume them (see ShmCaptureReader).\n"
+             "Must be called before start.")
+        .def("stop_shm_export", &QueueBasedProcessCapture::stopShmExport,
+             "Unmap the shared-memory export (call after stop)")
+        .def("set_metering", &QueueBasedProcessCapture::setMetering,
+             py::arg("enabled"), py::arg("metering_only") = false,
+             py::arg("window_ms") = 100,
+             "Compute peak/RMS levels in the capture thread (one SSE2 scan\n"
+             "per chunk). With metering_only=True chunks are discarded after\n"
+             "metering, so levels cost no queue or Python traffic. window_ms\n"
+             "must be set before start; the flags toggle at runtime.")
+        .def("get_levels", &QueueBasedProcessCapture::getLevels,
+             "Peak and RMS of the latest finished metering window - O(1),\n"
+             "does not touch the queue")
+        .def("set_replay", &QueueBasedProcessCapture::setReplay,
+             py::arg("seconds"), py::arg("replay_only") = false,
+             "Keep the last `seconds` of audio in a preallocated native\n"
+             "ring written at memcpy cost by the capture thread. seconds\n"
+             "must be set before start; replay_only (discard chunks after\n"
+             "the replay copy - no queue or Python traffic) toggles at\n"
+             "runtime. Snapshot with get_replay()/save_replay().")
+        .def("get_replay", &QueueBasedProcessCapture::getReplay,
+             "Snapshot the replay window as one (N, channels) float32\n"
+             "array, with first_frame on the chunk-sequence clock")
+        .def("save_replay", &QueueBasedProcessCapture::saveReplay,
+             py::arg("path"), py::arg("format") = "int16",
+             py::call_guard<py::gil_scoped_release>(),
+             "Snapshot the replay window straight to a WAV file (format\n"
+             "'int16' or 'float32'); returns frames written")
+        .def("set_silence_suppression", &QueueBasedProcessCapture::setSilenceSuppression,
+             py::arg("enabled"),
+             "Collapse silent stretches into gap records (dicts with\n"
+             "gap_frames > 0 and empty data, or zeros when popped with\n"
+             "expand_gaps=True). Must be called before start.")
+        .def("set_resample_rate", &QueueBasedProcessCapture::setResampleRate,
+             py::arg("rate"),
+             "Resample chunks to the given rate in the capture thread\n"
+             "(polyphase windowed-sinc; must be called before start; 0 or\n"
+             "48000 disables)")
+        .def("set_transform", &QueueBasedProcessCapture::setTransform,
+             py::arg("gain") = 1.0f, py::arg("mono") = false,
+             "Configure SIMD gain/downmix applied in the capture thread\n"
+             "(must be called before start). With mono=True chunks arrive\n"
+             "as (N, 1) arrays at half the memory cost.")
+        .def("pop_chunks", &QueueBasedProcessCapture::popChunks,
              py::arg("max_chunks") = 10, py::arg("timeout_ms") = 10,
-             "Pop multiple chunks from the queue")
+             py::arg("copy") = true, py::arg("expand_gaps") = false,
+             "Pop multiple chunks from the queue.\n\n"
+             "With copy=False each 'data' array is a zero-copy view over a\n"
+             "pooled capture buffer; the buffer is recycled when the array is\n"
+             "garbage-collected. Views are writable and alias pool memory, so\n"
+             "consume them promptly - every live view is one buffer the pool\n"
+             "cannot reuse.")
         .def("pop_chunk", &QueueBasedProcessCapture::popChunk,
-             py::arg("timeout_ms") = 10,
-             "Pop a single chunk from the queue")
+             py::arg("timeout_ms") = 10, py::arg("copy") = true,
+             py::arg("expand_gaps") = false,
+             "Pop a single chunk from the queue (see pop_chunks for the\n"
+             "copy=False aliasing rules)")
+        .def("pop_frames", &QueueBasedProcessCapture::popFrames,
+             py::arg("max_frames") = 48000, py::arg("timeout_ms") = 10,
+             "Pop up to max_frames coalesced into one contiguous (N, 2)\n"
+             "float32 array, with first_timestamp, silent_frames and a\n"
+             "discontinuity flag - replaces per-chunk pops plus Python-side\n"
+             "np.concatenate")
+        .def("start_recording", &QueueBasedProcessCapture::startRecording,
+             py::arg("path"), py::arg("format") = "int16",
+             "Record directly to a file from a native writer thread - the\n"
+             "queue is consumed in C++, so do not pop chunks while a\n"
+             "recording is active. format: 'int16' / 'float32' (WAV),\n"
+             "'flac' (lossless, use a .flac path) or 'aac' (lossy, use a\n"
+             ".m4a path; see set_encoder_bitrate). Compressed formats\n"
+             "encode on the writer thread via Media Foundation; encoder\n"
+             "CPU cost is reported as encoder_cpu_us in get_metrics().")
+        .def("set_encoder_bitrate", &QueueBasedProcessCapture::setEncoderBitrate,
+             py::arg("bits_per_second"),
+             "Target bitrate for the 'aac' recording format (default\n"
+             "192000; the Windows encoder snaps to its supported rates).\n"
+             "Must be called before start_recording; FLAC ignores it.")
+        .def("stop_recording", &QueueBasedProcessCapture::stopRecording,
+             py::call_guard<py::gil_scoped_release>(),
+             "Finalize the recording file; returns frames written")
+        .def("is_recording", &QueueBasedProcessCapture::isRecording,
+             "Check if the native recording sink is active")
         .def("queue_size", &QueueBasedProcessCapture::queueSize,
              "Get current queue size")
         .def("is_capturing", &QueueBasedProcessCapture::isCapturing,
              "Check if capture is active")
         .def("get_metrics", &QueueBasedProcessCapture::getMetrics,
-             "Get performance metrics");
+             py::arg("detailed") = false,
+             "Get performance metrics. With detailed=True includes\n"
+             "p50/p95/p99/max histograms for event-to-push latency, queue\n"
+             "residency time and WASAPI packet sizes, plus resource\n"
+             "self-profiling: capture-thread CPU time (capture_cpu_us),\n"
+             "bytes held by the queue (queue_bytes) and pool\n"
+             "(pool_free_bytes), peak queue depth and cumulative hot-path\n"
+             "copy volume (memcpy_bytes).");
     
+    // Shared-memory reader (attach from any process)
+    py::class_<ShmCaptureReader>(m, "ShmCaptureReader")
+        .def(py::init<const std::string&>(), py::arg("name"),
+             "Attach to a shared-memory ring exported with start_shm_export,\n"
+             "typically from a different process")
+        .def("read", &ShmCaptureReader::read, py::arg("max_frames") = 48000,
+             "Pull new frames since the last read: dict with (N, channels)\n"
+             "float32 data, absolute start_frame, and overrun count")
+        .def("info", &ShmCaptureReader::info,
+             "Ring format and progress counters");
+
+    // Multi-process capture engine
+    py::class_<MultiProcessCaptureEngine>(m, "MultiProcessCaptureEngine")
+        .def(py::init<size_t, size_t, size_t, size_t>(),
+             py::arg("num_threads") = 2, py::arg("queue_size") = 1000,
+             py::arg("chunk_size") = 480, py::arg("pool_size") = 256,
+             "Multiplex many process-loopback streams onto a fixed pool of\n"
+             "worker threads (one MMCSS registration per worker, shared chunk\n"
+             "buffer pool). Requires event-driven capture support.")
+        .def("add_stream", &MultiProcessCaptureEngine::addStream,
+             py::arg("process_id"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Start capturing a process; returns a stream id, or -1 on failure.\n"
+             "Blocks through COM activation (GIL released).")
+        .def("remove_stream", &MultiProcessCaptureEngine::removeStream,
+             py::arg("stream_id"),
+             "Stop and detach a stream (its id is not reused)")
+        .def("pop_chunks", &MultiProcessCaptureEngine::popChunks,
+             py::arg("stream_id"), py::arg("max_chunks") = 10, py::arg("timeout_ms") = 10,
+             "Pop chunks from one stream's queue")
+        .def("stream_count", &MultiProcessCaptureEngine::streamCount,
+             "Number of active streams")
+        .def("stop", &MultiProcessCaptureEngine::stop,
+             py::call_guard<py::gil_scoped_release>(),
+             "Stop all streams and join the worker threads")
+        .def("get_metrics", &MultiProcessCaptureEngine::getMetrics,
+             "Engine-wide and per-stream metrics");
+
+    // Native multi-stream mixer
+    py::class_<StreamMixer>(m, "StreamMixer")
+        .def(py::init<size_t, size_t>(),
+             py::arg("chunk_frames") = 480, py::arg("queue_size") = 1000,
+             "Mix N QueueBasedProcessCapture streams into one output stream\n"
+             "in C++ (per-stream gain, fused SIMD multiply-add). Source\n"
+             "queues are flushed at start() so streams begin sample-aligned;\n"
+             "a stalled stream is zero-filled rather than freezing the mix.")
+        .def("add_stream", &StreamMixer::addStream,
+             py::arg("capture"), py::arg("gain") = 1.0f,
+             py::keep_alive<1, 2>(),
+             "Register a capture as a mix input (before start); returns a\n"
+             "stream id. Do not pop chunks from a capture the mixer owns.")
+        .def("set_gain", &StreamMixer::setGain,
+             py::arg("stream_id"), py::arg("gain"),
+             "Adjust a stream's gain while mixing")
+        .def("start", &StreamMixer::start,
+             py::call_guard<py::gil_scoped_release>(),
+             "Start the mix thread (all inputs must already be capturing)")
+        .def("stop", &StreamMixer::stop,
+             py::call_guard<py::gil_scoped_release>(),
+             "Stop the mix thread")
+        .def("pop_chunks", &StreamMixer::popChunks,
+             py::arg("max_chunks") = 10, py::arg("timeout_ms") = 10,
+             "Pop mixed chunks: dicts with (N, channels) float32 data,\n"
+             "sequence and timestamp")
+        .def("queue_size", &StreamMixer::queueSize,
+             "Mixed chunks currently queued")
+        .def("is_running", &StreamMixer::isRunning,
+             "Check if the mix thread is active")
+        .def("get_metrics", &StreamMixer::getMetrics,
+             "Mixer and per-stream metrics (gain, starved frames)");
+
     // Module functions
     m.def("list_audio_processes", &listAudioProcesses,
-          "List all processes that might produce audio");
+          py::call_guard<py::gil_scoped_release>(),
+          "List all processes that might produce audio (walks every process\n"
+          "on the system; GIL released)");
+    m.def("get_resource_summary", &GetResourceSummary,
+          "Aggregate resource usage across every live\n"
+          "QueueBasedProcessCapture: instances, active stream count,\n"
+          "summed capture-thread CPU (capture_cpu_us), queue and pool\n"
+          "bytes, worst peak queue depth and cumulative memcpy_bytes -\n"
+          "the capacity-planning view for 'can this box take another\n"
+          "stream?'");
 }
\ No newline at end of file